@@ -1,43 +1,264 @@
+#ifndef KEY_TYPE
 #include "avl.h"
 #include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #define MAX_DATASIZE 1000000
 
+// Instantiate the code after #else once per key type; the parallel build below partitions by integer
+// key range, so it only exists for int keys
+#define KEYED_TEMPLATE "avl.c"
+#include "keys.inc"
+#undef KEYED_TEMPLATE
+
+// Work shared by the threads of a parallel build
+typedef struct ParallelBuild
+{
+    int *dataset;
+    int dataSize;
+    int *partitioned;
+    int *counts;  // counts[thread * threads + bucket] = keys of `thread`'s slice in `bucket`
+    int *offsets; // Same layout as counts, start of each slice/bucket pair in `partitioned`
+    int *bucketStarts;
+    AVLNode **roots;
+    int threads;
+    int min;
+    int max;
+} ParallelBuild;
+
+// Arguments of a single worker thread
+typedef struct ParallelBuildTask
+{
+    ParallelBuild *build;
+    int thread;
+    int phase;
+    int min;
+    int max;
+} ParallelBuildTask;
+
+// Helper function to map a key to the thread that owns its key range
+int findBucketAVL(ParallelBuild *build, int key)
+{
+    long long span = (long long)build->max - build->min + 1;
+    return (int)(((long long)key - build->min) * build->threads / span);
+}
+
+// Helper function run by each worker thread for one phase of the parallel build
+void *runParallelBuildTask(void *arg)
+{
+    ParallelBuildTask *task = arg;
+    ParallelBuild *build = task->build;
+    int first = (int)((long long)build->dataSize * task->thread / build->threads);
+    int last = (int)((long long)build->dataSize * (task->thread + 1) / build->threads);
+
+    if (task->phase == 0)
+    {
+        // Find the key range of this thread's slice
+        task->min = INT_MAX;
+        task->max = INT_MIN;
+        for (int i = first; i < last; i++)
+        {
+            if (build->dataset[i] < task->min)
+                task->min = build->dataset[i];
+            if (build->dataset[i] > task->max)
+                task->max = build->dataset[i];
+        }
+    }
+    else if (task->phase == 1)
+    {
+        // Count how many keys of this slice fall into each key range
+        int *counts = build->counts + task->thread * build->threads;
+        for (int i = first; i < last; i++)
+        {
+            counts[findBucketAVL(build, build->dataset[i])]++;
+        }
+    }
+    else if (task->phase == 2)
+    {
+        // Scatter this slice into the key-range partitions
+        int *offsets = build->offsets + task->thread * build->threads;
+        for (int i = first; i < last; i++)
+        {
+            int bucket = findBucketAVL(build, build->dataset[i]);
+            build->partitioned[offsets[bucket]++] = build->dataset[i];
+        }
+    }
+    else
+    {
+        // Sort, deduplicate and bulk-build the subtree of this key range
+        int *keys = build->partitioned + build->bucketStarts[task->thread];
+        int count = build->bucketStarts[task->thread + 1] - build->bucketStarts[task->thread];
+        qsort(keys, count, sizeof(int), compareKeysAVL);
+
+        int distinct = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (distinct == 0 || keys[i] != keys[distinct - 1])
+                keys[distinct++] = keys[i];
+        }
+        build->roots[task->thread] = buildSortedAVLNodes(keys, distinct);
+    }
+
+    return NULL;
+}
+
+// Helper function to run one phase of the parallel build on every thread
+void runParallelBuildPhase(ParallelBuild *build, ParallelBuildTask *tasks, pthread_t *workers, int phase)
+{
+    // Tasks whose thread cannot be created run serially on the calling thread instead, as does a single task
+    bool *started = malloc(build->threads * sizeof(bool));
+    for (int t = 0; t < build->threads; t++)
+    {
+        tasks[t].phase = phase;
+        started[t] =
+            build->threads > 1 && pthread_create(&workers[t], NULL, runParallelBuildTask, &tasks[t]) == 0;
+        if (!started[t])
+            runParallelBuildTask(&tasks[t]);
+    }
+    for (int t = 0; t < build->threads; t++)
+    {
+        if (started[t])
+            pthread_join(workers[t], NULL);
+    }
+    free(started);
+}
+
+// Function to insert data from the dataset into the AVL Tree using several threads; a single thread runs the same
+// partition, sort and bulk-build steps on the calling thread
+void insertDataAVLParallel(AVLTree *tree, int *dataset, int dataSize, int threads)
+{
+    compare();
+    if (threads > MAX_BUILD_THREADS)
+        threads = MAX_BUILD_THREADS;
+    compare();
+    if (threads < 1)
+        threads = 1;
+
+    compare();
+    if (dataSize < threads)
+    {
+        insertDataAVL(tree, dataset, dataSize);
+        return;
+    }
+
+    // Keys already in the tree are merged in after the build
+    compare();
+    if (tree->root != NULL)
+    {
+        AVLTree *built = createAVLTree();
+        insertDataAVLParallel(built, dataset, dataSize, threads);
+        unionAVL(tree, built);
+        destroyAVLTree(built);
+        return;
+    }
+
+    ParallelBuild build = {dataset, dataSize, NULL, NULL, NULL, NULL, NULL, threads, 0, 0};
+    size_t pairs = (size_t)threads * threads;
+    ParallelBuildTask *tasks = malloc((size_t)threads * sizeof(ParallelBuildTask));
+    pthread_t *workers = malloc((size_t)threads * sizeof(pthread_t));
+    build.partitioned = malloc((size_t)dataSize * sizeof(int));
+    build.counts = calloc(pairs, sizeof(int));
+    build.offsets = malloc(pairs * sizeof(int));
+    build.bucketStarts = malloc(((size_t)threads + 1) * sizeof(int));
+    build.roots = malloc((size_t)threads * sizeof(AVLNode *));
+    for (int t = 0; t < threads; t++)
+    {
+        ParallelBuildTask task = {&build, t, 0, 0, 0};
+        tasks[t] = task;
+    }
+
+    // Phase 0: key range of the whole dataset
+    runParallelBuildPhase(&build, tasks, workers, 0);
+    build.min = tasks[0].min;
+    build.max = tasks[0].max;
+    for (int t = 1; t < threads; t++)
+    {
+        build.min = tasks[t].min < build.min ? tasks[t].min : build.min;
+        build.max = tasks[t].max > build.max ? tasks[t].max : build.max;
+    }
+
+    // Phases 1 and 2: partition the keys into disjoint ranges, one per thread
+    runParallelBuildPhase(&build, tasks, workers, 1);
+    int offset = 0;
+    for (int bucket = 0; bucket < threads; bucket++)
+    {
+        build.bucketStarts[bucket] = offset;
+        for (int t = 0; t < threads; t++)
+        {
+            build.offsets[t * threads + bucket] = offset;
+            offset += build.counts[t * threads + bucket];
+        }
+    }
+    build.bucketStarts[threads] = offset;
+    runParallelBuildPhase(&build, tasks, workers, 2);
+
+    // Phase 3: per-range subtrees, which are then joined in key order
+    runParallelBuildPhase(&build, tasks, workers, 3);
+    AVLNode *root = NULL;
+    for (int t = 0; t < threads; t++)
+    {
+        root = joinAVLNodes2(root, build.roots[t]);
+    }
+    invalidateFrequenciesAVL(tree);
+    tree->root = root;
+
+    free(tasks);
+    free(workers);
+    free(build.partitioned);
+    free(build.counts);
+    free(build.offsets);
+    free(build.bucketStarts);
+    free(build.roots);
+}
+
+#else /* Instantiated once per key type by keys.inc */
+
 // Function to create an empty AVL Tree
-AVLTree *createAVLTree()
+KEYED(AVLTree) *KEYED(createAVLTree)()
 {
-    AVLTree *tree = malloc(sizeof(AVLTree));
+    KEYED(AVLTree) *tree = malloc(sizeof(KEYED(AVLTree)));
     tree->root = NULL;
+    tree->frequencies = NULL;
     return tree;
 }
 
 // Helper function to free the memory occupied by the AVL nodes
-void destroyAVLNodes(AVLNode *node)
+void KEYED(destroyAVLNodes)(KEYED(AVLNode) *node)
 {
     if (node != NULL)
     {
-        destroyAVLNodes(node->left);
-        destroyAVLNodes(node->right);
+        KEYED(destroyAVLNodes)(node->left);
+        KEYED(destroyAVLNodes)(node->right);
         free(node);
     }
 }
 
 // Function to destroy the AVL Tree and free memory
-void destroyAVLTree(AVLTree *tree)
+void KEYED(destroyAVLTree)(KEYED(AVLTree) *tree)
 {
-    destroyAVLNodes(tree->root);
+    KEYED(destroyAVLNodes)(tree->root);
+    KEYED(destroyFrequencyTable)(tree->frequencies);
     free(tree);
 }
 
+// Helper function to drop the cached key frequencies after a modification
+void KEYED(invalidateFrequenciesAVL)(KEYED(AVLTree) *tree)
+{
+    KEYED(destroyFrequencyTable)(tree->frequencies);
+    tree->frequencies = NULL;
+}
+
 // Helper function to create a new AVL node
-AVLNode *createAVLNode(int key)
+KEYED(AVLNode) *KEYED(createAVLNode)(KEY_TYPE key)
 {
-    AVLNode *node = (AVLNode *)malloc(sizeof(AVLNode));
+    KEYED(AVLNode) *node = (KEYED(AVLNode) *)malloc(sizeof(KEYED(AVLNode)));
     node->key = key;
+    node->count = 1;
     node->left = NULL;
     node->right = NULL;
     node->height = 1;
@@ -46,7 +267,7 @@ AVLNode *createAVLNode(int key)
 }
 
 // Helper function to update the height and size of a node
-void updateNode(AVLNode *node)
+void KEYED(updateNode)(KEYED(AVLNode) *node)
 {
     compare();
     int left_height = node->left ? node->left->height : 0;
@@ -57,135 +278,496 @@ void updateNode(AVLNode *node)
     node->height = 1 + (left_height > right_height ? left_height : right_height);
     compare();
     compare();
-    node->size = 1 + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
+    node->size = node->count + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
 }
 
 // Helper function to perform a right rotation on the AVL Tree
-AVLNode *rightRotateAVL(AVLNode *y)
+KEYED(AVLNode) *KEYED(rightRotateAVL)(KEYED(AVLNode) *y)
 {
     compare();
     if (y == NULL || y->left == NULL)
         return y;
+    rotate();
 
-    AVLNode *x = y->left;
-    AVLNode *T2 = x->right;
+    KEYED(AVLNode) *x = y->left;
+    KEYED(AVLNode) *T2 = x->right;
 
     // Perform the rotation
     x->right = y;
     y->left = T2;
 
     // Update heights and sizes
-    updateNode(y);
-    updateNode(x);
+    KEYED(updateNode)(y);
+    KEYED(updateNode)(x);
 
     return x;
 }
 
 // Helper function to perform a left rotation on the AVL Tree
-AVLNode *leftRotateAVL(AVLNode *x)
+KEYED(AVLNode) *KEYED(leftRotateAVL)(KEYED(AVLNode) *x)
 {
     compare();
     if (x == NULL || x->right == NULL)
         return x;
+    rotate();
 
-    AVLNode *y = x->right;
-    AVLNode *T2 = y->left;
+    KEYED(AVLNode) *y = x->right;
+    KEYED(AVLNode) *T2 = y->left;
 
     // Perform the rotation
     y->left = x;
     x->right = T2;
 
     // Update heights and sizes
-    updateNode(x);
-    updateNode(y);
+    KEYED(updateNode)(x);
+    KEYED(updateNode)(y);
 
     return y;
 }
 
 // Helper function to insert a key into the AVL Tree
-AVLNode *insertAVLNode(AVLNode *node, int key)
+KEYED(AVLNode) *KEYED(insertAVLNode)(KEYED(AVLNode) *node, KEY_TYPE key)
 {
     compare();
     if (node == NULL)
-        return createAVLNode(key);
+        return KEYED(createAVLNode)(key);
 
     compare();
-    if (key < node->key)
-        node->left = insertAVLNode(node->left, key);
-    else if (key > node->key)
-        node->right = insertAVLNode(node->right, key);
+    if (KEY_LESS(key, node->key))
+        node->left = KEYED(insertAVLNode)(node->left, key);
+    else if (KEY_LESS(node->key, key))
+        node->right = KEYED(insertAVLNode)(node->right, key);
     else
         return node;
 
     // Update height and size
-    updateNode(node);
+    KEYED(updateNode)(node);
 
     // Calculate balance factor
     int balance = (node->left ? node->left->height : 0) - (node->right ? node->right->height : 0);
 
     // Left-Left case
     compare();
-    if (balance > 1 && key < node->left->key)
-        return rightRotateAVL(node);
+    if (balance > 1 && KEY_LESS(key, node->left->key))
+        return KEYED(rightRotateAVL)(node);
 
     // Right-Right case
     compare();
-    if (balance < -1 && key > node->right->key)
-        return leftRotateAVL(node);
+    if (balance < -1 && KEY_LESS(node->right->key, key))
+        return KEYED(leftRotateAVL)(node);
 
     // Left-Right case
     compare();
-    if (balance > 1 && key > node->left->key)
+    if (balance > 1 && KEY_LESS(node->left->key, key))
     {
-        node->left = leftRotateAVL(node->left);
-        return rightRotateAVL(node);
+        node->left = KEYED(leftRotateAVL)(node->left);
+        return KEYED(rightRotateAVL)(node);
     }
 
     // Right-Left case
     compare();
-    if (balance < -1 && key < node->right->key)
+    if (balance < -1 && KEY_LESS(key, node->right->key))
     {
-        node->right = rightRotateAVL(node->right);
-        return leftRotateAVL(node);
+        node->right = KEYED(rightRotateAVL)(node->right);
+        return KEYED(leftRotateAVL)(node);
+    }
+
+    return node;
+}
+
+// Helper function to compute the balance factor of a node
+int KEYED(balanceAVL)(KEYED(AVLNode) *node)
+{
+    return (node->left ? node->left->height : 0) - (node->right ? node->right->height : 0);
+}
+
+// Helper function to restore the AVL property at a node whose subtrees are balanced
+KEYED(AVLNode) *KEYED(rebalanceAVLNode)(KEYED(AVLNode) *node)
+{
+    KEYED(updateNode)(node);
+    int balance = KEYED(balanceAVL)(node);
+
+    // Left-heavy: Left-Left or Left-Right case
+    compare();
+    if (balance > 1)
+    {
+        compare();
+        if (KEYED(balanceAVL)(node->left) < 0)
+            node->left = KEYED(leftRotateAVL)(node->left);
+        return KEYED(rightRotateAVL)(node);
+    }
+
+    // Right-heavy: Right-Right or Right-Left case
+    compare();
+    if (balance < -1)
+    {
+        compare();
+        if (KEYED(balanceAVL)(node->right) > 0)
+            node->right = KEYED(rightRotateAVL)(node->right);
+        return KEYED(leftRotateAVL)(node);
     }
 
     return node;
 }
 
 // Function to insert a key into the AVL Tree
-void insertAVL(AVLTree *tree, int key)
+void KEYED(insertAVL)(KEYED(AVLTree) *tree, KEY_TYPE key)
+{
+    KEYED(invalidateFrequenciesAVL)(tree);
+    tree->root = KEYED(insertAVLNode)(tree->root, key);
+}
+
+// Helper function to delete a key from the AVL Tree
+KEYED(AVLNode) *KEYED(deleteAVLNode)(KEYED(AVLNode) *node, KEY_TYPE key)
+{
+    compare();
+    if (node == NULL)
+        return NULL;
+
+    compare();
+    if (KEY_LESS(key, node->key))
+        node->left = KEYED(deleteAVLNode)(node->left, key);
+    else if (KEY_LESS(node->key, key))
+        node->right = KEYED(deleteAVLNode)(node->right, key);
+    else
+    {
+        // Nodes with at most one child are replaced by that child
+        compare();
+        if (node->left == NULL || node->right == NULL)
+        {
+            KEYED(AVLNode) *child = node->left ? node->left : node->right;
+            free(node);
+            return child;
+        }
+
+        // Otherwise take over the in-order successor's key and delete it instead
+        KEYED(AVLNode) *successor = node->right;
+        compare();
+        while (successor->left != NULL)
+        {
+            successor = successor->left;
+            compare();
+        }
+        node->key = successor->key;
+        node->count = successor->count;
+        node->right = KEYED(deleteAVLNode)(node->right, successor->key);
+    }
+
+    return KEYED(rebalanceAVLNode)(node);
+}
+
+// Function to delete a key from the AVL Tree
+void KEYED(deleteAVL)(KEYED(AVLTree) *tree, KEY_TYPE key)
+{
+    KEYED(invalidateFrequenciesAVL)(tree);
+    tree->root = KEYED(deleteAVLNode)(tree->root, key);
+}
+
+// Helper function to get the height of a possibly empty subtree
+int KEYED(heightAVL)(KEYED(AVLNode) *node)
+{
+    return node ? node->height : 0;
+}
+
+// Helper function to join two trees under `middle` when the left tree is taller
+KEYED(AVLNode) *KEYED(joinRightAVL)(KEYED(AVLNode) *left, KEYED(AVLNode) *middle, KEYED(AVLNode) *right)
+{
+    compare();
+    if (KEYED(heightAVL)(left->right) <= KEYED(heightAVL)(right) + 1)
+    {
+        middle->left = left->right;
+        middle->right = right;
+        KEYED(updateNode)(middle);
+        left->right = middle;
+    }
+    else
+    {
+        left->right = KEYED(joinRightAVL)(left->right, middle, right);
+    }
+
+    return KEYED(rebalanceAVLNode)(left);
+}
+
+// Helper function to join two trees under `middle` when the right tree is taller
+KEYED(AVLNode) *KEYED(joinLeftAVL)(KEYED(AVLNode) *left, KEYED(AVLNode) *middle, KEYED(AVLNode) *right)
+{
+    compare();
+    if (KEYED(heightAVL)(right->left) <= KEYED(heightAVL)(left) + 1)
+    {
+        middle->left = left;
+        middle->right = right->left;
+        KEYED(updateNode)(middle);
+        right->left = middle;
+    }
+    else
+    {
+        right->left = KEYED(joinLeftAVL)(left, middle, right->left);
+    }
+
+    return KEYED(rebalanceAVLNode)(right);
+}
+
+// Helper function to join two trees whose keys are all smaller/larger than middle->key
+KEYED(AVLNode) *KEYED(joinAVLNodes)(KEYED(AVLNode) *left, KEYED(AVLNode) *middle, KEYED(AVLNode) *right)
+{
+    compare();
+    if (KEYED(heightAVL)(left) > KEYED(heightAVL)(right) + 1)
+        return KEYED(joinRightAVL)(left, middle, right);
+
+    compare();
+    if (KEYED(heightAVL)(right) > KEYED(heightAVL)(left) + 1)
+        return KEYED(joinLeftAVL)(left, middle, right);
+
+    middle->left = left;
+    middle->right = right;
+    KEYED(updateNode)(middle);
+    return middle;
+}
+
+// Helper function to detach the minimum node of a subtree, returning the new subtree root
+KEYED(AVLNode) *KEYED(removeMinAVLNode)(KEYED(AVLNode) *node, KEYED(AVLNode) **min)
+{
+    compare();
+    if (node->left == NULL)
+    {
+        *min = node;
+        return node->right;
+    }
+
+    node->left = KEYED(removeMinAVLNode)(node->left, min);
+    return KEYED(rebalanceAVLNode)(node);
+}
+
+// Helper function to join two trees whose keys are all smaller/larger than each other
+KEYED(AVLNode) *KEYED(joinAVLNodes2)(KEYED(AVLNode) *left, KEYED(AVLNode) *right)
+{
+    compare();
+    if (left == NULL)
+        return right;
+    compare();
+    if (right == NULL)
+        return left;
+
+    KEYED(AVLNode) *middle;
+    right = KEYED(removeMinAVLNode)(right, &middle);
+    return KEYED(joinAVLNodes)(left, middle, right);
+}
+
+// Helper function to split a subtree into keys smaller and larger than `key`, returning the detached match
+KEYED(AVLNode) *KEYED(splitAVLNode)(KEYED(AVLNode) *node, KEY_TYPE key, KEYED(AVLNode) **left, KEYED(AVLNode) **right)
+{
+    compare();
+    if (node == NULL)
+    {
+        *left = NULL;
+        *right = NULL;
+        return NULL;
+    }
+
+    KEYED(AVLNode) *found;
+    KEYED(AVLNode) *subtreeLeft = node->left;
+    KEYED(AVLNode) *subtreeRight = node->right;
+
+    compare();
+    if (KEY_LESS(key, node->key))
+    {
+        found = KEYED(splitAVLNode)(subtreeLeft, key, left, &subtreeLeft);
+        *right = KEYED(joinAVLNodes)(subtreeLeft, node, subtreeRight);
+    }
+    else if (KEY_LESS(node->key, key))
+    {
+        found = KEYED(splitAVLNode)(subtreeRight, key, &subtreeRight, right);
+        *left = KEYED(joinAVLNodes)(subtreeLeft, node, subtreeRight);
+    }
+    else
+    {
+        *left = subtreeLeft;
+        *right = subtreeRight;
+        node->left = NULL;
+        node->right = NULL;
+        KEYED(updateNode)(node);
+        found = node;
+    }
+
+    return found;
+}
+
+// Helper function to merge two subtrees into one holding the keys of either
+KEYED(AVLNode) *KEYED(unionAVLNodes)(KEYED(AVLNode) *first, KEYED(AVLNode) *second)
+{
+    compare();
+    if (first == NULL)
+        return second;
+    compare();
+    if (second == NULL)
+        return first;
+
+    KEYED(AVLNode) *secondLeft, *secondRight;
+    KEYED(AVLNode) *duplicate = KEYED(splitAVLNode)(second, first->key, &secondLeft, &secondRight);
+    free(duplicate);
+
+    KEYED(AVLNode) *left = KEYED(unionAVLNodes)(first->left, secondLeft);
+    KEYED(AVLNode) *right = KEYED(unionAVLNodes)(first->right, secondRight);
+    return KEYED(joinAVLNodes)(left, first, right);
+}
+
+// Helper function to merge two subtrees into one holding the keys found in both
+KEYED(AVLNode) *KEYED(intersectAVLNodes)(KEYED(AVLNode) *first, KEYED(AVLNode) *second)
+{
+    compare();
+    if (first == NULL || second == NULL)
+    {
+        KEYED(destroyAVLNodes)(first);
+        KEYED(destroyAVLNodes)(second);
+        return NULL;
+    }
+
+    KEYED(AVLNode) *secondLeft, *secondRight;
+    KEYED(AVLNode) *match = KEYED(splitAVLNode)(second, first->key, &secondLeft, &secondRight);
+    KEYED(AVLNode) *left = KEYED(intersectAVLNodes)(first->left, secondLeft);
+    KEYED(AVLNode) *right = KEYED(intersectAVLNodes)(first->right, secondRight);
+
+    compare();
+    if (match != NULL)
+    {
+        free(match);
+        return KEYED(joinAVLNodes)(left, first, right);
+    }
+
+    free(first);
+    return KEYED(joinAVLNodes2)(left, right);
+}
+
+// Helper function to remove the keys of the second subtree from the first one
+KEYED(AVLNode) *KEYED(differenceAVLNodes)(KEYED(AVLNode) *first, KEYED(AVLNode) *second)
+{
+    compare();
+    if (first == NULL || second == NULL)
+    {
+        KEYED(destroyAVLNodes)(second);
+        return first;
+    }
+
+    KEYED(AVLNode) *firstLeft, *firstRight;
+    KEYED(AVLNode) *match = KEYED(splitAVLNode)(first, second->key, &firstLeft, &firstRight);
+    free(match);
+
+    KEYED(AVLNode) *left = KEYED(differenceAVLNodes)(firstLeft, second->left);
+    KEYED(AVLNode) *right = KEYED(differenceAVLNodes)(firstRight, second->right);
+    free(second);
+    return KEYED(joinAVLNodes2)(left, right);
+}
+
+// Function to add every key of `other` to the AVL Tree, leaving `other` empty
+void KEYED(unionAVL)(KEYED(AVLTree) *tree, KEYED(AVLTree) *other)
 {
-    tree->root = insertAVLNode(tree->root, key);
+    KEYED(invalidateFrequenciesAVL)(tree);
+    KEYED(invalidateFrequenciesAVL)(other);
+    tree->root = KEYED(unionAVLNodes)(tree->root, other->root);
+    other->root = NULL;
+}
+
+// Function to keep only the keys of the AVL Tree that are also in `other`, leaving `other` empty
+void KEYED(intersectAVL)(KEYED(AVLTree) *tree, KEYED(AVLTree) *other)
+{
+    KEYED(invalidateFrequenciesAVL)(tree);
+    KEYED(invalidateFrequenciesAVL)(other);
+    tree->root = KEYED(intersectAVLNodes)(tree->root, other->root);
+    other->root = NULL;
+}
+
+// Function to remove the keys of `other` from the AVL Tree, leaving `other` empty
+void KEYED(differenceAVL)(KEYED(AVLTree) *tree, KEYED(AVLTree) *other)
+{
+    KEYED(invalidateFrequenciesAVL)(tree);
+    KEYED(invalidateFrequenciesAVL)(other);
+    tree->root = KEYED(differenceAVLNodes)(tree->root, other->root);
+    other->root = NULL;
 }
 
 // Helper function to recursively print the AVL Tree
-void printAVLNode(AVLNode *node)
+void KEYED(printAVLNode)(KEYED(AVLNode) *node)
 {
     if (node != NULL)
     {
-        printAVLNode(node->left);
-        printf("%d ", node->key);
-        printAVLNode(node->right);
+        KEYED(printAVLNode)(node->left);
+        KEY_PRINT(node->key);
+        KEYED(printAVLNode)(node->right);
     }
 }
 
 // Function to print the AVL Tree
-void printAVL(AVLTree *tree)
+void KEYED(printAVL)(KEYED(AVLTree) *tree)
 {
-    printAVLNode(tree->root);
+    KEYED(printAVLNode)(tree->root);
     printf("\n");
 }
 
+// Function to check whether a key is in the AVL Tree
+bool KEYED(searchAVL)(KEYED(AVLTree) *tree, KEY_TYPE key)
+{
+    KEYED(AVLNode) *current = tree->root;
+
+    compare();
+    while (current != NULL)
+    {
+        compare();
+        if (KEY_LESS(key, current->key))
+            current = current->left;
+        else if (KEY_LESS(current->key, key))
+            current = current->right;
+        else
+            return true;
+        compare();
+    }
+
+    return false;
+}
+
+// Helper function to copy the keys of a subtree in order
+void KEYED(copyKeysAVLNode)(KEYED(AVLNode) *node, KEY_TYPE *keys, int *count)
+{
+    if (node != NULL)
+    {
+        KEYED(copyKeysAVLNode)(node->left, keys, count);
+        keys[(*count)++] = node->key;
+        KEYED(copyKeysAVLNode)(node->right, keys, count);
+    }
+}
+
+// Function to copy the keys of the AVL Tree in ascending order, returning how many were copied
+int KEYED(copyKeysAVL)(KEYED(AVLTree) *tree, KEY_TYPE *keys)
+{
+    int count = 0;
+    KEYED(copyKeysAVLNode)(tree->root, keys, &count);
+    return count;
+}
+
+// Function to compare two keys for qsort
+int KEYED(compareKeysAVL)(const void *a, const void *b)
+{
+    const KEY_TYPE *x = a;
+    const KEY_TYPE *y = b;
+    return KEY_LESS(*y, *x) - KEY_LESS(*x, *y);
+}
+
+// Helper function to compare two keys for qsort, counting the comparison (not thread-safe, unlike compareKeysAVL)
+int KEYED(compareKeysCountedAVL)(const void *a, const void *b)
+{
+    compare();
+    return KEYED(compareKeysAVL)(a, b);
+}
+
 // Function to find the minimum value in the AVL Tree
-int findMinAVL(AVLTree *tree)
+KEY_TYPE KEYED(findMinAVL)(KEYED(AVLTree) *tree)
 {
-    AVLNode *current = tree->root;
+    KEYED(AVLNode) *current = tree->root;
 
     compare();
     if (current == NULL)
     {
         printf("Tree is empty.\n");
-        return -1;
+        return KEY_NONE;
     }
 
     compare();
@@ -199,15 +781,15 @@ int findMinAVL(AVLTree *tree)
 }
 
 // Function to find the maximum value in the AVL Tree
-int findMaxAVL(AVLTree *tree)
+KEY_TYPE KEYED(findMaxAVL)(KEYED(AVLTree) *tree)
 {
-    AVLNode *current = tree->root;
+    KEYED(AVLNode) *current = tree->root;
 
     compare();
     if (current == NULL)
     {
         printf("Tree is empty.\n");
-        return -1;
+        return KEY_NONE;
     }
 
     while (current->right != NULL)
@@ -219,37 +801,39 @@ int findMaxAVL(AVLTree *tree)
     return current->key;
 }
 
+#ifdef KEY_SUM
 // Helper function to recursively calculate the average value in the AVL Tree
-double calculateAverageAVLNode(AVLNode *node, unsigned long long *sum, int *numNodes)
+double KEYED(calculateAverageAVLNode)(KEYED(AVLNode) *node, KEY_SUM *sum, int *numNodes)
 {
     compare();
     if (node == NULL)
         return 0.0;
 
-    calculateAverageAVLNode(node->left, sum, numNodes);
+    KEYED(calculateAverageAVLNode)(node->left, sum, numNodes);
     *sum += node->key;
     (*numNodes)++;
-    calculateAverageAVLNode(node->right, sum, numNodes);
+    KEYED(calculateAverageAVLNode)(node->right, sum, numNodes);
 
     return (double)(*sum) / (*numNodes);
 }
 
 // Function to calculate the average value in the AVL Tree
-double calculateAverageAVL(AVLTree *tree)
+double KEYED(calculateAverageAVL)(KEYED(AVLTree) *tree)
 {
-    unsigned long long sum = 0;
+    KEY_SUM sum = 0;
     int numNodes = 0;
 
-    return calculateAverageAVLNode(tree->root, &sum, &numNodes);
+    return KEYED(calculateAverageAVLNode)(tree->root, &sum, &numNodes);
 }
+#endif
 
 // Helper function to find the frequency of each key in the AVL Tree
-void findKeyFrequenciesAVL(AVLNode *node, int dataSize, KeyFrequency *frequencies, int *arrSize)
+void KEYED(findKeyFrequenciesAVL)(KEYED(AVLNode) *node, int dataSize, KEYED(KeyFrequency) *frequencies, int *arrSize)
 {
     compare();
     if (node != NULL)
     {
-        findKeyFrequenciesAVL(node->left, dataSize, frequencies, arrSize);
+        KEYED(findKeyFrequenciesAVL)(node->left, dataSize, frequencies, arrSize);
 
         bool keyFound = false;
         compare();
@@ -257,7 +841,7 @@ void findKeyFrequenciesAVL(AVLNode *node, int dataSize, KeyFrequency *frequencie
         for (int i = 0; (i < *arrSize) && (!keyFound); i++)
         {
             compare();
-            if (frequencies[i].key == node->key)
+            if (KEY_EQUAL(frequencies[i].key, node->key))
             {
                 frequencies[i].frequency++;
                 keyFound = true;
@@ -268,17 +852,17 @@ void findKeyFrequenciesAVL(AVLNode *node, int dataSize, KeyFrequency *frequencie
         compare();
         if (!keyFound)
         {
-            KeyFrequency newKey = {node->key, 1};
+            KEYED(KeyFrequency) newKey = {node->key, 1};
             frequencies[*arrSize] = newKey;
             (*arrSize)++;
         }
 
-        findKeyFrequenciesAVL(node->right, dataSize, frequencies, arrSize);
+        KEYED(findKeyFrequenciesAVL)(node->right, dataSize, frequencies, arrSize);
     }
 }
 
 // Function to find the X most frequent values in the AVL Tree
-KeyFrequency *findXMostFrequentAVL(AVLTree *tree, int X, int dataSize)
+KEYED(KeyFrequency) *KEYED(findXMostFrequentAVL)(KEYED(AVLTree) *tree, int X, int dataSize)
 {
     compare();
     if (tree == NULL || X <= 0)
@@ -286,18 +870,18 @@ KeyFrequency *findXMostFrequentAVL(AVLTree *tree, int X, int dataSize)
         return NULL;
     }
 
-    KeyFrequency *frequencies = calloc(dataSize, sizeof(KeyFrequency));
-    KeyFrequency *result = calloc(X, sizeof(KeyFrequency));
+    KEYED(KeyFrequency) *frequencies = calloc(dataSize, sizeof(KEYED(KeyFrequency)));
+    KEYED(KeyFrequency) *result = calloc(X, sizeof(KEYED(KeyFrequency)));
     int frequencies_size = 0;
 
     // Find the frequency of each key in the tree
-    findKeyFrequenciesAVL(tree->root, dataSize, frequencies, &frequencies_size);
+    KEYED(findKeyFrequenciesAVL)(tree->root, dataSize, frequencies, &frequencies_size);
 
     // Find the X highest frequencies in the array
     compare();
     for (int i = 0; i < X; i++)
     {
-        KeyFrequency most_frequent = {0, 0};
+        KEYED(KeyFrequency) most_frequent = {KEY_NONE, 0};
         int most_frequent_index = -1;
         compare();
         for (int j = 0; j < frequencies_size; j++)
@@ -310,21 +894,390 @@ KeyFrequency *findXMostFrequentAVL(AVLTree *tree, int X, int dataSize)
             }
             compare();
         }
+        compare();
+        if (most_frequent_index == -1) // Fewer than X distinct keys
+            break;
         result[i] = most_frequent;
         frequencies[most_frequent_index].frequency = -1; // Prevent key from being counted again
         compare();
     }
 
+    free(frequencies);
     return result;
 }
 
+// Helper function to count every key of a subtree into a Frequency Table
+void KEYED(countFrequenciesAVL)(KEYED(AVLNode) *node, KEYED(FrequencyTable) *table)
+{
+    compare();
+    if (node != NULL)
+    {
+        KEYED(countFrequenciesAVL)(node->left, table);
+        KEYED(incrementFrequency)(table, node->key);
+        KEYED(countFrequenciesAVL)(node->right, table);
+    }
+}
+
+// Function to find the most frequent values for several X at once: the answer for Xs[i] is the first Xs[i]
+// entries of the returned top-max(X) ranking, and the counts are cached until the tree changes
+KEYED(KeyFrequency) *KEYED(findXMostFrequentMultiAVL)(KEYED(AVLTree) *tree, int *Xs, int count)
+{
+    compare();
+    if (tree == NULL || Xs == NULL || count <= 0)
+    {
+        return NULL;
+    }
+
+    int maxX = 0;
+    compare();
+    for (int i = 0; i < count; i++)
+    {
+        compare();
+        if (Xs[i] > maxX)
+            maxX = Xs[i];
+        compare();
+    }
+
+    compare();
+    if (tree->frequencies == NULL)
+    {
+        tree->frequencies = KEYED(createFrequencyTable)(tree->root ? tree->root->size : 0);
+        KEYED(countFrequenciesAVL)(tree->root, tree->frequencies);
+    }
+
+    return KEYED(findXMostFrequentTable)(tree->frequencies, maxX);
+}
+
 // Function to insert data from the dataset into the AVL Tree
-void insertDataAVL(AVLTree *tree, int *dataset, int dataSize)
+void KEYED(insertDataAVL)(KEYED(AVLTree) *tree, KEY_TYPE *dataset, int dataSize)
 {
     compare();
     for (int i = 0; i < dataSize; i++)
     {
-        insertAVL(tree, dataset[i]);
+        KEYED(insertAVL)(tree, dataset[i]);
+        compare();
+    }
+}
+
+// Function to count the keys in the AVL Tree that are smaller than `key`, counting every copy of a key
+int KEYED(rankAVL)(KEYED(AVLTree) *tree, KEY_TYPE key)
+{
+    KEYED(AVLNode) *current = tree->root;
+    int rank = 0;
+
+    compare();
+    while (current != NULL)
+    {
+        compare();
+        if (!KEY_LESS(current->key, key))
+        {
+            current = current->left;
+        }
+        else
+        {
+            rank += current->count + (current->left ? current->left->size : 0);
+            current = current->right;
+        }
         compare();
     }
+
+    return rank;
 }
+
+// Function to find the k-th smallest key (0-based) in the AVL Tree, counting every copy of a key
+KEY_TYPE KEYED(selectAVL)(KEYED(AVLTree) *tree, int k)
+{
+    KEYED(AVLNode) *current = tree->root;
+
+    compare();
+    if (current == NULL || k < 0 || k >= current->size)
+        return KEY_NONE;
+
+    compare();
+    while (current != NULL)
+    {
+        int leftSize = current->left ? current->left->size : 0;
+        compare();
+        if (k < leftSize)
+        {
+            current = current->left;
+        }
+        else if (k >= leftSize + current->count)
+        {
+            k -= leftSize + current->count;
+            current = current->right;
+        }
+        else
+        {
+            return current->key;
+        }
+        compare();
+    }
+
+    return KEY_NONE;
+}
+
+// Function to count the keys in the AVL Tree within [low, high]
+int KEYED(countRangeAVL)(KEYED(AVLTree) *tree, KEY_TYPE low, KEY_TYPE high)
+{
+    compare();
+    if (tree->root == NULL || KEY_LESS(high, low))
+        return 0;
+
+    // Count the keys <= high by ranking high and checking for an exact match
+    int upper = KEYED(rankAVL)(tree, high);
+    KEYED(AVLNode) *current = tree->root;
+    compare();
+    while (current != NULL && !KEY_EQUAL(current->key, high))
+    {
+        current = KEY_LESS(high, current->key) ? current->left : current->right;
+        compare();
+    }
+    if (current != NULL)
+        upper += current->count;
+
+    return upper - KEYED(rankAVL)(tree, low);
+}
+
+// Helper function to add `delta` copies of a key that is already in the AVL Tree
+void KEYED(addCopiesAVL)(KEYED(AVLTree) *tree, KEY_TYPE key, int delta)
+{
+    KEYED(invalidateFrequenciesAVL)(tree);
+
+    // Only counts change, so the sizes along the search path are patched without rebalancing
+    KEYED(AVLNode) *current = tree->root;
+    compare();
+    while (current != NULL)
+    {
+        current->size += delta;
+        compare();
+        if (KEY_EQUAL(key, current->key))
+        {
+            current->count += delta;
+            return;
+        }
+        current = KEY_LESS(key, current->key) ? current->left : current->right;
+        compare();
+    }
+}
+
+// Function to create an empty sliding window over the last `window` insertions
+KEYED(WindowedAVL) *KEYED(createWindowedAVL)(int window)
+{
+    KEYED(WindowedAVL) *windowed = malloc(sizeof(KEYED(WindowedAVL)));
+    windowed->tree = KEYED(createAVLTree)();
+    windowed->frequencies = KEYED(createFrequencyTable)(window);
+    windowed->keys = malloc(window * sizeof(KEY_TYPE));
+    windowed->window = window;
+    windowed->front = 0;
+    windowed->count = 0;
+    return windowed;
+}
+
+// Function to destroy the sliding window and free memory
+void KEYED(destroyWindowedAVL)(KEYED(WindowedAVL) *window)
+{
+    KEYED(destroyAVLTree)(window->tree);
+    KEYED(destroyFrequencyTable)(window->frequencies);
+    free(window->keys);
+    free(window);
+}
+
+// Function to insert a key into the sliding window, deleting expired keys from the tree
+void KEYED(insertWindowedAVL)(KEYED(WindowedAVL) *window, KEY_TYPE key)
+{
+    compare();
+    if (window->count == window->window)
+    {
+        KEY_TYPE expired = window->keys[window->front];
+        window->front = (window->front + 1) % window->window;
+        window->count--;
+
+        // Only the last copy of a key leaving the window removes its node from the tree
+        compare();
+        if (KEYED(decrementFrequency)(window->frequencies, expired) == 0)
+            KEYED(deleteAVL)(window->tree, expired);
+        else
+            KEYED(addCopiesAVL)(window->tree, expired, -1);
+    }
+
+    window->keys[(window->front + window->count) % window->window] = key;
+    window->count++;
+
+    compare();
+    if (KEYED(incrementFrequency)(window->frequencies, key) == 1)
+        KEYED(insertAVL)(window->tree, key);
+    else
+        KEYED(addCopiesAVL)(window->tree, key, 1);
+}
+
+// Function to count the insertions in the sliding window whose key lies within [low, high]
+int KEYED(countRangeWindowedAVL)(KEYED(WindowedAVL) *window, KEY_TYPE low, KEY_TYPE high)
+{
+    return KEYED(countRangeAVL)(window->tree, low, high);
+}
+
+// Function to find the key at a percentile (0-100) of the insertions in the sliding window
+KEY_TYPE KEYED(findPercentileWindowedAVL)(KEYED(WindowedAVL) *window, double percentile)
+{
+    compare();
+    if (window->tree->root == NULL)
+    {
+        printf("Window is empty.\n");
+        return KEY_NONE;
+    }
+
+    int size = window->tree->root->size;
+    int k = (int)(percentile / 100.0 * (size - 1) + 0.5);
+    return KEYED(selectAVL)(window->tree, k);
+}
+
+// Function to insert data from the dataset into the sliding window
+void KEYED(insertDataWindowedAVL)(KEYED(WindowedAVL) *window, KEY_TYPE *dataset, int dataSize)
+{
+    compare();
+    for (int i = 0; i < dataSize; i++)
+    {
+        KEYED(insertWindowedAVL)(window, dataset[i]);
+        compare();
+    }
+}
+
+// Helper function to build a perfectly balanced subtree from sorted, distinct keys
+KEYED(AVLNode) *KEYED(buildSortedAVLNodes)(KEY_TYPE *keys, int count)
+{
+    if (count <= 0)
+        return NULL;
+
+    // Heights and sizes are set directly so that worker threads never touch comparisonCount
+    int middle = count / 2;
+    KEYED(AVLNode) *node = KEYED(createAVLNode)(keys[middle]);
+    node->left = KEYED(buildSortedAVLNodes)(keys, middle);
+    node->right = KEYED(buildSortedAVLNodes)(keys + middle + 1, count - middle - 1);
+    int leftHeight = KEYED(heightAVL)(node->left);
+    int rightHeight = KEYED(heightAVL)(node->right);
+    node->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    node->size = count;
+    return node;
+}
+
+// Entry of the finger path kept by batched insertion
+typedef struct KEYED(FingerEntry)
+{
+    KEYED(AVLNode) *node;
+    KEY_TYPE upper; // When bounded, every key of this subtree is smaller than `upper`
+    bool bounded;
+    bool isLeft; // Whether the node hangs off the left of the previous entry
+} KEYED(FingerEntry);
+
+// Helper function to leave the subtree on top of the finger path, rebalancing it on the way out
+int KEYED(popFingerAVL)(KEYED(AVLTree) *tree, KEYED(FingerEntry) *path, int depth)
+{
+    // Both children are valid AVL trees by now, but their heights may be arbitrarily far apart
+    KEYED(FingerEntry) entry = path[--depth];
+    KEYED(AVLNode) *fixed = KEYED(joinAVLNodes)(entry.node->left, entry.node, entry.node->right);
+
+    if (depth == 0)
+        tree->root = fixed;
+    else if (entry.isLeft)
+        path[depth - 1].node->left = fixed;
+    else
+        path[depth - 1].node->right = fixed;
+
+    return depth;
+}
+
+// Function to insert a batch of keys into the AVL Tree, resuming each descent from the previous position
+void KEYED(insertBatchAVL)(KEYED(AVLTree) *tree, KEY_TYPE *keys, int count)
+{
+    compare();
+    if (count <= 0)
+        return;
+
+    KEYED(invalidateFrequenciesAVL)(tree);
+    KEY_TYPE *sorted = malloc(count * sizeof(KEY_TYPE));
+    memcpy(sorted, keys, count * sizeof(KEY_TYPE));
+    qsort(sorted, count, sizeof(KEY_TYPE), KEYED(compareKeysCountedAVL));
+
+    // The path can grow by one node per inserted key before any of them is rebalanced
+    KEYED(FingerEntry) *path = malloc((KEYED(heightAVL)(tree->root) + count + 1) * sizeof(KEYED(FingerEntry)));
+    int depth = 0;
+    compare();
+    if (tree->root != NULL)
+    {
+        KEYED(FingerEntry) rootEntry = {tree->root, KEY_NONE, false, false};
+        path[depth++] = rootEntry;
+    }
+
+    compare();
+    for (int i = 0; i < count; i++)
+    {
+        KEY_TYPE key = sorted[i];
+
+        // Climb until the subtree on top of the path is the one that can hold the key
+        compare();
+        while (depth > 0 && path[depth - 1].bounded && !KEY_LESS(key, path[depth - 1].upper))
+        {
+            depth = KEYED(popFingerAVL)(tree, path, depth);
+            compare();
+        }
+
+        compare();
+        if (depth == 0)
+        {
+            tree->root = KEYED(createAVLNode)(key);
+            KEYED(FingerEntry) rootEntry = {tree->root, KEY_NONE, false, false};
+            path[depth++] = rootEntry;
+            continue;
+        }
+
+        // Descend from the finger as an unbalanced BST insertion
+        KEYED(AVLNode) *current = path[depth - 1].node;
+        KEY_TYPE upper = path[depth - 1].upper;
+        bool bounded = path[depth - 1].bounded;
+        while (true)
+        {
+            compare();
+            if (KEY_EQUAL(key, current->key))
+                break;
+
+            compare();
+            bool goLeft = KEY_LESS(key, current->key);
+            KEYED(AVLNode) *child = goLeft ? current->left : current->right;
+            compare();
+            if (child == NULL)
+            {
+                child = KEYED(createAVLNode)(key);
+                if (goLeft)
+                    current->left = child;
+                else
+                    current->right = child;
+            }
+
+            if (goLeft)
+            {
+                upper = current->key;
+                bounded = true;
+            }
+            KEYED(FingerEntry) entry = {child, upper, bounded, goLeft};
+            path[depth++] = entry;
+
+            if (KEY_EQUAL(child->key, key))
+                break;
+            current = child;
+        }
+    }
+
+    // Rebalance whatever is still on the path
+    compare();
+    while (depth > 0)
+    {
+        depth = KEYED(popFingerAVL)(tree, path, depth);
+        compare();
+    }
+
+    free(sorted);
+    free(path);
+}
+
+#endif /* KEY_TYPE */
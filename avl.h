@@ -1,34 +1,84 @@
+#ifndef KEY_TYPE
 #ifndef AVL_H
 #define AVL_H
 
+#include "freq.h"
 #include "main.h"
+#include <stdbool.h>
+
+#define MAX_BUILD_THREADS 256 // Upper bound on the threads used by insertDataAVLParallel
+
+// Declare the types and functions after #else once per key type
+#define KEYED_TEMPLATE "avl.h"
+#include "keys.inc"
+#undef KEYED_TEMPLATE
+
+void insertDataAVLParallel(AVLTree *tree, int *dataset, int dataSize, int threads); // int keys only
+
+#endif /* AVL_H */
+#else /* Instantiated once per key type by keys.inc */
 
 // Node structure for AVL Tree
-typedef struct AVLNode
+typedef struct KEYED(AVLNode)
 {
-    int key;
-    struct AVLNode *left;
-    struct AVLNode *right;
+    KEY_TYPE key;
+    int count; // Copies of the key, always 1 outside a WindowedAVL
+    struct KEYED(AVLNode) *left;
+    struct KEYED(AVLNode) *right;
     int height;
-    int size;
-} AVLNode;
+    int size; // Sum of the counts in the subtree
+} KEYED(AVLNode);
 
 // AVL Tree ADT
-typedef struct AVLTree
+typedef struct KEYED(AVLTree)
 {
-    AVLNode *root;
-} AVLTree;
+    KEYED(AVLNode) *root;
+    KEYED(FrequencyTable) *frequencies; // Cached key frequencies, dropped by every modification
+} KEYED(AVLTree);
 
-struct AVLTree *createAVLTree(); // Core ADT Functions
-void destroyAVLTree(struct AVLTree *tree);
-void insertAVL(struct AVLTree *tree, int key);
-void printAVL(struct AVLTree *tree);
+// Sliding-window view over the last W insertions, each key weighted by its copies in the window
+typedef struct KEYED(WindowedAVL)
+{
+    KEYED(AVLTree) *tree;               // One node per distinct key, counting its copies in the window
+    KEYED(FrequencyTable) *frequencies; // Multiplicity of each key inside the window
+    KEY_TYPE *keys;                     // Ring buffer of the window in insertion order
+    int window;
+    int front;
+    int count;
+} KEYED(WindowedAVL);
 
-int findMinAVL(struct AVLTree *tree); // Statistical Functions
-int findMaxAVL(struct AVLTree *tree);
-double calculateAverageAVL(struct AVLTree *tree);
-KeyFrequency *findXMostFrequentAVL(AVLTree *tree, int X, int dataSize);
+KEYED(AVLTree) *KEYED(createAVLTree)(); // Core ADT Functions
+void KEYED(destroyAVLTree)(KEYED(AVLTree) *tree);
+void KEYED(insertAVL)(KEYED(AVLTree) *tree, KEY_TYPE key);
+void KEYED(deleteAVL)(KEYED(AVLTree) *tree, KEY_TYPE key);
+bool KEYED(searchAVL)(KEYED(AVLTree) *tree, KEY_TYPE key);
+int KEYED(copyKeysAVL)(KEYED(AVLTree) *tree, KEY_TYPE *keys);
+int KEYED(compareKeysAVL)(const void *a, const void *b);
+void KEYED(printAVL)(KEYED(AVLTree) *tree);
 
-void insertDataAVL(AVLTree *tree, int *dataset, int dataSize); // Data Management Functions
+void KEYED(unionAVL)(KEYED(AVLTree) *tree, KEYED(AVLTree) *other); // Set Operations
+void KEYED(intersectAVL)(KEYED(AVLTree) *tree, KEYED(AVLTree) *other);
+void KEYED(differenceAVL)(KEYED(AVLTree) *tree, KEYED(AVLTree) *other);
 
-#endif /* AVL_H */
+KEY_TYPE KEYED(findMinAVL)(KEYED(AVLTree) *tree); // Statistical Functions
+KEY_TYPE KEYED(findMaxAVL)(KEYED(AVLTree) *tree);
+#ifdef KEY_SUM
+double KEYED(calculateAverageAVL)(KEYED(AVLTree) *tree);
+#endif
+KEYED(KeyFrequency) *KEYED(findXMostFrequentAVL)(KEYED(AVLTree) *tree, int X, int dataSize);
+KEYED(KeyFrequency) *KEYED(findXMostFrequentMultiAVL)(KEYED(AVLTree) *tree, int *Xs, int count);
+int KEYED(rankAVL)(KEYED(AVLTree) *tree, KEY_TYPE key);
+KEY_TYPE KEYED(selectAVL)(KEYED(AVLTree) *tree, int k);
+int KEYED(countRangeAVL)(KEYED(AVLTree) *tree, KEY_TYPE low, KEY_TYPE high);
+
+void KEYED(insertDataAVL)(KEYED(AVLTree) *tree, KEY_TYPE *dataset, int dataSize); // Data Management Functions
+void KEYED(insertBatchAVL)(KEYED(AVLTree) *tree, KEY_TYPE *keys, int count);
+
+KEYED(WindowedAVL) *KEYED(createWindowedAVL)(int window); // Sliding-window functions
+void KEYED(destroyWindowedAVL)(KEYED(WindowedAVL) *window);
+void KEYED(insertWindowedAVL)(KEYED(WindowedAVL) *window, KEY_TYPE key);
+int KEYED(countRangeWindowedAVL)(KEYED(WindowedAVL) *window, KEY_TYPE low, KEY_TYPE high);
+KEY_TYPE KEYED(findPercentileWindowedAVL)(KEYED(WindowedAVL) *window, double percentile);
+void KEYED(insertDataWindowedAVL)(KEYED(WindowedAVL) *window, KEY_TYPE *dataset, int dataSize);
+
+#endif /* KEY_TYPE */
@@ -1,34 +1,142 @@
+#ifndef KEY_TYPE
 #include "dll.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Instantiate the code after #else once per key type
+#define KEYED_TEMPLATE "dll.c"
+#include "keys.inc"
+#undef KEYED_TEMPLATE
+
+#else /* Instantiated once per key type by keys.inc */
 
 // Function to create an empty Doubly-Linked LIst
-DoublyLinkedList *createDoublyLinkedList()
+KEYED(DoublyLinkedList) *KEYED(createDoublyLinkedList)()
 {
-    DoublyLinkedList *list = (DoublyLinkedList *)malloc(sizeof(DoublyLinkedList));
+    KEYED(DoublyLinkedList) *list = (KEYED(DoublyLinkedList) *)malloc(sizeof(KEYED(DoublyLinkedList)));
     list->head = NULL;
     list->tail = NULL;
+    list->frequencies = NULL;
+    list->block = NULL;
+    list->blockLength = 0;
+    list->blockMappedBytes = 0;
     return list;
 }
 
+// Helper function to free a node unless it lives in the compacted block
+void KEYED(freeDLLNode)(KEYED(DoublyLinkedList) *list, KEYED(DLLNode) *node)
+{
+    if (list->block == NULL || node < list->block || node >= list->block + list->blockLength)
+        free(node);
+}
+
+// Helper function to release the compacted block
+void KEYED(releaseDLLBlock)(KEYED(DoublyLinkedList) *list)
+{
+    if (list->blockMappedBytes > 0)
+        munmap(list->block, list->blockMappedBytes);
+    else
+        free(list->block);
+    list->block = NULL;
+    list->blockLength = 0;
+    list->blockMappedBytes = 0;
+}
+
 // Function to destroy the Doubly-Linked List and free memory
-void destroyDoublyLinkedList(DoublyLinkedList *list)
+void KEYED(destroyDoublyLinkedList)(KEYED(DoublyLinkedList) *list)
 {
-    DLLNode *current = list->head;
+    KEYED(DLLNode) *current = list->head;
     while (current != NULL)
     {
-        DLLNode *temp = current;
+        KEYED(DLLNode) *temp = current;
         current = current->next;
-        free(temp);
+        KEYED(freeDLLNode)(list, temp);
     }
+    KEYED(releaseDLLBlock)(list);
+    KEYED(destroyFrequencyTable)(list->frequencies);
     free(list);
 }
 
+// Function to relocate the nodes into one contiguous block in list order, optionally backed by huge pages
+void KEYED(compactDLL)(KEYED(DoublyLinkedList) *list, bool hugePages)
+{
+    size_t length = 0;
+    for (KEYED(DLLNode) *current = list->head; current != NULL; current = current->next)
+    {
+        length++;
+    }
+    if (length == 0)
+        return;
+
+    KEYED(DLLNode) *block = NULL;
+    size_t mappedBytes = 0;
+    if (hugePages)
+    {
+        // Round up to whole huge pages so the kernel can back the block with transparent huge pages
+        mappedBytes = (length * sizeof(KEYED(DLLNode)) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+        // The kernel need not align the mapping to a huge page, so map one extra and trim both ends to align it
+        size_t paddedBytes = mappedBytes + HUGE_PAGE_SIZE;
+        char *mapping = mmap(NULL, paddedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            mappedBytes = 0;
+        }
+        else
+        {
+            uintptr_t start = ((uintptr_t)mapping + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1);
+            size_t head = start - (uintptr_t)mapping;
+            if (head > 0)
+                munmap(mapping, head);
+            if (paddedBytes - head > mappedBytes)
+                munmap((char *)start + mappedBytes, paddedBytes - head - mappedBytes);
+            block = (KEYED(DLLNode) *)start;
+#ifdef MADV_HUGEPAGE
+            madvise(block, mappedBytes, MADV_HUGEPAGE);
+#endif
+        }
+    }
+    if (block == NULL)
+        block = malloc(length * sizeof(KEYED(DLLNode)));
+
+    // Copy the nodes in list order, linking each one to its neighbours in the block
+    KEYED(DLLNode) *current = list->head;
+    for (size_t i = 0; i < length; i++)
+    {
+        block[i].key = current->key;
+        block[i].prev = i > 0 ? &block[i - 1] : NULL;
+        block[i].next = i + 1 < length ? &block[i + 1] : NULL;
+
+        KEYED(DLLNode) *next = current->next;
+        KEYED(freeDLLNode)(list, current);
+        current = next;
+    }
+
+    KEYED(releaseDLLBlock)(list);
+    list->block = block;
+    list->blockLength = length;
+    list->blockMappedBytes = mappedBytes;
+    list->head = &block[0];
+    list->tail = &block[length - 1];
+}
+
+// Helper function to drop the cached key frequencies after a modification
+void KEYED(invalidateFrequenciesDLL)(KEYED(DoublyLinkedList) *list)
+{
+    KEYED(destroyFrequencyTable)(list->frequencies);
+    list->frequencies = NULL;
+}
+
 // Function to insert a key into the Doubly-Linked List
-void insertDLL(DoublyLinkedList *list, int key)
+void KEYED(insertDLL)(KEYED(DoublyLinkedList) *list, KEY_TYPE key)
 {
-    DLLNode *newNode = (DLLNode *)malloc(sizeof(DLLNode));
+    KEYED(invalidateFrequenciesDLL)(list);
+    KEYED(DLLNode) *newNode = (KEYED(DLLNode) *)malloc(sizeof(KEYED(DLLNode)));
     newNode->key = key;
     newNode->prev = list->tail;
     newNode->next = NULL;
@@ -46,34 +154,34 @@ void insertDLL(DoublyLinkedList *list, int key)
 }
 
 // Function to print the Doubly-Linked List
-void printDLL(DoublyLinkedList *list)
+void KEYED(printDLL)(KEYED(DoublyLinkedList) *list)
 {
-    DLLNode *current = list->head;
+    KEYED(DLLNode) *current = list->head;
     while (current != NULL)
     {
-        printf("%d ", current->key);
+        KEY_PRINT(current->key);
         current = current->next;
     }
     printf("\n");
 }
 
 // Function to find the minimum value in the Doubly-Linked List
-int findMinDLL(DoublyLinkedList *list)
+KEY_TYPE KEYED(findMinDLL)(KEYED(DoublyLinkedList) *list)
 {
     compare();
     if (list->head == NULL)
     {
         printf("List is empty.\n");
-        return -1;
+        return KEY_NONE;
     }
 
-    int min = list->head->key;
-    DLLNode *current = list->head->next;
+    KEY_TYPE min = list->head->key;
+    KEYED(DLLNode) *current = list->head->next;
     compare();
     while (current != NULL)
     {
         compare();
-        if (current->key < min)
+        if (KEY_LESS(current->key, min))
         {
             min = current->key;
         }
@@ -85,22 +193,22 @@ int findMinDLL(DoublyLinkedList *list)
 }
 
 // Function to find the maximum value in the Doubly-Linked List
-int findMaxDLL(DoublyLinkedList *list)
+KEY_TYPE KEYED(findMaxDLL)(KEYED(DoublyLinkedList) *list)
 {
     compare();
     if (list->head == NULL)
     {
         printf("List is empty.\n");
-        return -1;
+        return KEY_NONE;
     }
 
-    int max = list->head->key;
-    DLLNode *current = list->head->next;
+    KEY_TYPE max = list->head->key;
+    KEYED(DLLNode) *current = list->head->next;
     compare();
     while (current != NULL)
     {
         compare();
-        if (current->key > max)
+        if (KEY_LESS(max, current->key))
         {
             max = current->key;
         }
@@ -111,8 +219,9 @@ int findMaxDLL(DoublyLinkedList *list)
     return max;
 }
 
+#ifdef KEY_SUM
 // Function to calculate the average value in the Doubly-Linked List
-float calculateAverageDLL(DoublyLinkedList *list)
+float KEYED(calculateAverageDLL)(KEYED(DoublyLinkedList) *list)
 {
     compare();
     if (list->head == NULL)
@@ -121,10 +230,10 @@ float calculateAverageDLL(DoublyLinkedList *list)
         return -1;
     }
 
-    unsigned long long sum = 0;
+    KEY_SUM sum = 0;
     int count = 0;
 
-    DLLNode *current = list->head;
+    KEYED(DLLNode) *current = list->head;
     compare();
     while (current != NULL)
     {
@@ -136,9 +245,10 @@ float calculateAverageDLL(DoublyLinkedList *list)
 
     return (sum / (float)count);
 }
+#endif
 
 // Function to find the X most frequent values in the Doubly-Linked List
-KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize)
+KEYED(KeyFrequency) *KEYED(findXMostFrequentDLL)(KEYED(DoublyLinkedList) *list, int X, int dataSize)
 {
     compare();
     if (list->head == NULL || X <= 0)
@@ -146,12 +256,12 @@ KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize)
         return NULL;
     }
 
-    KeyFrequency *frequencies = calloc(dataSize, sizeof(KeyFrequency));
-    KeyFrequency *result = calloc(X, sizeof(KeyFrequency));
+    KEYED(KeyFrequency) *frequencies = calloc(dataSize, sizeof(KEYED(KeyFrequency)));
+    KEYED(KeyFrequency) *result = calloc(X, sizeof(KEYED(KeyFrequency)));
     int frequencies_size = 0;
 
     // Find the frequency of each value in the list
-    DLLNode *current = list->head;
+    KEYED(DLLNode) *current = list->head;
     compare();
     while (current != NULL)
     {
@@ -161,7 +271,7 @@ KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize)
         for (int i = 0; (i < frequencies_size) && (!keyExists); i++)
         {
             compare();
-            if (current->key == frequencies[i].key)
+            if (KEY_EQUAL(current->key, frequencies[i].key))
             {
                 keyExists = true;
                 frequencies[i].frequency++;
@@ -172,7 +282,7 @@ KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize)
         compare();
         if (!keyExists)
         {
-            KeyFrequency newKey = {current->key, 1};
+            KEYED(KeyFrequency) newKey = {current->key, 1};
             frequencies[frequencies_size] = newKey;
             frequencies_size++;
         }
@@ -184,7 +294,7 @@ KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize)
     compare();
     for (int i = 0; i < X; i++)
     {
-        KeyFrequency most_frequent = {0, 0};
+        KEYED(KeyFrequency) most_frequent = {KEY_NONE, 0};
         int most_frequent_index = -1;
         compare();
         for (int j = 0; j < frequencies_size; j++)
@@ -197,21 +307,235 @@ KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize)
             }
             compare();
         }
+        compare();
+        if (most_frequent_index == -1) // Fewer than X distinct keys
+            break;
         result[i] = most_frequent;
         frequencies[most_frequent_index].frequency = -1; // Prevent key from being counted again
         compare();
     }
 
+    free(frequencies);
     return result;
 }
 
+// Function to find the most frequent values for several X at once: the answer for Xs[i] is the first Xs[i]
+// entries of the returned top-max(X) ranking, and the counts are cached until the list changes
+KEYED(KeyFrequency) *KEYED(findXMostFrequentMultiDLL)(KEYED(DoublyLinkedList) *list, int *Xs, int count)
+{
+    compare();
+    if (list == NULL || Xs == NULL || count <= 0)
+    {
+        return NULL;
+    }
+
+    int maxX = 0;
+    compare();
+    for (int i = 0; i < count; i++)
+    {
+        compare();
+        if (Xs[i] > maxX)
+            maxX = Xs[i];
+        compare();
+    }
+
+    compare();
+    if (list->frequencies == NULL)
+    {
+        int length = 0;
+        compare();
+        for (KEYED(DLLNode) *current = list->head; current != NULL; current = current->next)
+        {
+            length++;
+            compare();
+        }
+
+        list->frequencies = KEYED(createFrequencyTable)(length);
+        compare();
+        for (KEYED(DLLNode) *current = list->head; current != NULL; current = current->next)
+        {
+            KEYED(incrementFrequency)(list->frequencies, current->key);
+            compare();
+        }
+    }
+
+    return KEYED(findXMostFrequentTable)(list->frequencies, maxX);
+}
+
 // Function to insert data from the dataset into the AVL Tree
-void insertDataDLL(DoublyLinkedList *list, int *dataset, int dataSize)
+void KEYED(insertDataDLL)(KEYED(DoublyLinkedList) *list, KEY_TYPE *dataset, int dataSize)
 {
     compare();
     for (int i = 0; i < dataSize; i++)
     {
-        insertDLL(list, dataset[i]);
+        KEYED(insertDLL)(list, dataset[i]);
         compare();
     }
 }
+
+// Function to create an empty sliding window over the last `window` insertions
+KEYED(WindowedDLL) *KEYED(createWindowedDLL)(int window)
+{
+    KEYED(WindowedDLL) *windowed = malloc(sizeof(KEYED(WindowedDLL)));
+    windowed->list = KEYED(createDoublyLinkedList)();
+    windowed->frequencies = KEYED(createFrequencyTable)(window);
+    windowed->minDeque = malloc(window * sizeof(KEYED(WindowEntry)));
+    windowed->maxDeque = malloc(window * sizeof(KEYED(WindowEntry)));
+    windowed->minFront = 0;
+    windowed->minCount = 0;
+    windowed->maxFront = 0;
+    windowed->maxCount = 0;
+#ifdef KEY_SUM
+    windowed->sum = 0;
+#endif
+    windowed->inserted = 0;
+    windowed->window = window;
+    windowed->count = 0;
+    return windowed;
+}
+
+// Function to destroy the sliding window and free memory
+void KEYED(destroyWindowedDLL)(KEYED(WindowedDLL) *window)
+{
+    KEYED(destroyDoublyLinkedList)(window->list);
+    KEYED(destroyFrequencyTable)(window->frequencies);
+    free(window->minDeque);
+    free(window->maxDeque);
+    free(window);
+}
+
+// Helper function to push a key onto a monotonic deque, dropping entries it dominates
+static void KEYED(pushWindowDeque)(KEYED(WindowEntry) *deque, int front, int *count, int capacity,
+                                   KEYED(WindowEntry) entry, bool keepMin)
+{
+    compare();
+    while (*count > 0)
+    {
+        KEYED(WindowEntry) back = deque[(front + *count - 1) % capacity];
+        compare();
+        if (keepMin ? KEY_LESS(back.key, entry.key) : KEY_LESS(entry.key, back.key))
+            break;
+        (*count)--;
+        compare();
+    }
+    deque[(front + *count) % capacity] = entry;
+    (*count)++;
+}
+
+// Helper function to unlink and free the oldest node of the window
+static void KEYED(evictWindowedDLL)(KEYED(WindowedDLL) *window)
+{
+    KEYED(DLLNode) *oldest = window->list->head;
+    KEYED(invalidateFrequenciesDLL)(window->list);
+    long long sequence = window->inserted - window->count;
+
+    window->list->head = oldest->next;
+    compare();
+    if (window->list->head != NULL)
+        window->list->head->prev = NULL;
+    else
+        window->list->tail = NULL;
+
+#ifdef KEY_SUM
+    window->sum -= oldest->key;
+#endif
+    KEYED(decrementFrequency)(window->frequencies, oldest->key);
+
+    // The expiring entry can only sit at the front of each deque
+    compare();
+    if (window->minCount > 0 && window->minDeque[window->minFront].sequence == sequence)
+    {
+        window->minFront = (window->minFront + 1) % window->window;
+        window->minCount--;
+    }
+    compare();
+    if (window->maxCount > 0 && window->maxDeque[window->maxFront].sequence == sequence)
+    {
+        window->maxFront = (window->maxFront + 1) % window->window;
+        window->maxCount--;
+    }
+
+    KEYED(freeDLLNode)(window->list, oldest);
+    window->count--;
+}
+
+// Function to insert a key into the sliding window, evicting the oldest key when full
+void KEYED(insertWindowedDLL)(KEYED(WindowedDLL) *window, KEY_TYPE key)
+{
+    compare();
+    if (window->count == window->window)
+        KEYED(evictWindowedDLL)(window);
+
+    KEYED(insertDLL)(window->list, key);
+#ifdef KEY_SUM
+    window->sum += key;
+#endif
+    KEYED(incrementFrequency)(window->frequencies, key);
+
+    KEYED(WindowEntry) entry = {key, window->inserted};
+    KEYED(pushWindowDeque)(window->minDeque, window->minFront, &window->minCount, window->window, entry, true);
+    KEYED(pushWindowDeque)(window->maxDeque, window->maxFront, &window->maxCount, window->window, entry, false);
+
+    window->inserted++;
+    window->count++;
+}
+
+// Function to find the minimum value in the sliding window
+KEY_TYPE KEYED(findMinWindowedDLL)(KEYED(WindowedDLL) *window)
+{
+    compare();
+    if (window->count == 0)
+    {
+        printf("Window is empty.\n");
+        return KEY_NONE;
+    }
+
+    return window->minDeque[window->minFront].key;
+}
+
+// Function to find the maximum value in the sliding window
+KEY_TYPE KEYED(findMaxWindowedDLL)(KEYED(WindowedDLL) *window)
+{
+    compare();
+    if (window->count == 0)
+    {
+        printf("Window is empty.\n");
+        return KEY_NONE;
+    }
+
+    return window->maxDeque[window->maxFront].key;
+}
+
+#ifdef KEY_SUM
+// Function to calculate the average value in the sliding window
+double KEYED(calculateAverageWindowedDLL)(KEYED(WindowedDLL) *window)
+{
+    compare();
+    if (window->count == 0)
+    {
+        printf("Window is empty.\n");
+        return -1;
+    }
+
+    return (double)window->sum / window->count;
+}
+#endif
+
+// Function to find the X most frequent values in the sliding window
+KEYED(KeyFrequency) *KEYED(findXMostFrequentWindowedDLL)(KEYED(WindowedDLL) *window, int X)
+{
+    return KEYED(findXMostFrequentTable)(window->frequencies, X);
+}
+
+// Function to insert data from the dataset into the sliding window
+void KEYED(insertDataWindowedDLL)(KEYED(WindowedDLL) *window, KEY_TYPE *dataset, int dataSize)
+{
+    compare();
+    for (int i = 0; i < dataSize; i++)
+    {
+        KEYED(insertWindowedDLL)(window, dataset[i]);
+        compare();
+    }
+}
+
+#endif /* KEY_TYPE */
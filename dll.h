@@ -1,33 +1,88 @@
+#ifndef KEY_TYPE
 #ifndef DLL_H
 #define DLL_H
 
+#include "freq.h"
 #include "main.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Declare the types and functions after #else once per key type
+#define KEYED_TEMPLATE "dll.h"
+#include "keys.inc"
+#undef KEYED_TEMPLATE
+
+#endif /* DLL_H */
+#else /* Instantiated once per key type by keys.inc */
 
 // Node structure for Doubly-Linked-List
-typedef struct DLLNode
+typedef struct KEYED(DLLNode)
 {
-    int key;
-    struct DLLNode *prev;
-    struct DLLNode *next;
-} DLLNode;
+    KEY_TYPE key;
+    struct KEYED(DLLNode) *prev;
+    struct KEYED(DLLNode) *next;
+} KEYED(DLLNode);
 
 // Doubly-Linked List ADT
-typedef struct DoublyLinkedList
+typedef struct KEYED(DoublyLinkedList)
 {
-    DLLNode *head;
-    DLLNode *tail;
-} DoublyLinkedList;
+    KEYED(DLLNode) *head;
+    KEYED(DLLNode) *tail;
+    KEYED(FrequencyTable) *frequencies; // Cached key frequencies, dropped by every modification
+    KEYED(DLLNode) *block;              // Contiguous nodes left by the last compaction (NULL if never compacted)
+    size_t blockLength;
+    size_t blockMappedBytes; // Size of the mapping when the block was mmap'ed, 0 when malloc'ed
+} KEYED(DoublyLinkedList);
 
-DoublyLinkedList *createDoublyLinkedList(); // Core ADT functions
-void destroyDoublyLinkedList(DoublyLinkedList *list);
-void insertDLL(DoublyLinkedList *list, int key);
-void printDLL(DoublyLinkedList *list);
+// Monotonic deque entry used by the sliding window
+typedef struct KEYED(WindowEntry)
+{
+    KEY_TYPE key;
+    long long sequence;
+} KEYED(WindowEntry);
 
-int findMinDLL(DoublyLinkedList *list); // Statistical functions
-int findMaxDLL(DoublyLinkedList *list);
-float calculateAverageDLL(DoublyLinkedList *list);
-KeyFrequency *findXMostFrequentDLL(DoublyLinkedList *list, int X, int dataSize);
+// Sliding-window view over the last W insertions of a Doubly-Linked List
+typedef struct KEYED(WindowedDLL)
+{
+    KEYED(DoublyLinkedList) *list;
+    KEYED(FrequencyTable) *frequencies;
+    KEYED(WindowEntry) *minDeque; // Ring buffer with increasing keys, front is the window minimum
+    KEYED(WindowEntry) *maxDeque; // Ring buffer with decreasing keys, front is the window maximum
+    int minFront, minCount;
+    int maxFront, maxCount;
+#ifdef KEY_SUM
+    KEY_SUM sum;
+#endif
+    long long inserted;
+    int window;
+    int count;
+} KEYED(WindowedDLL);
 
-void insertDataDLL(DoublyLinkedList *list, int *dataset, int dataSize); // Data Management Functions
+KEYED(DoublyLinkedList) *KEYED(createDoublyLinkedList)(); // Core ADT functions
+void KEYED(destroyDoublyLinkedList)(KEYED(DoublyLinkedList) *list);
+void KEYED(insertDLL)(KEYED(DoublyLinkedList) *list, KEY_TYPE key);
+void KEYED(printDLL)(KEYED(DoublyLinkedList) *list);
+void KEYED(compactDLL)(KEYED(DoublyLinkedList) *list, bool hugePages);
 
-#endif /* DLL_H */
+KEY_TYPE KEYED(findMinDLL)(KEYED(DoublyLinkedList) *list); // Statistical functions
+KEY_TYPE KEYED(findMaxDLL)(KEYED(DoublyLinkedList) *list);
+#ifdef KEY_SUM
+float KEYED(calculateAverageDLL)(KEYED(DoublyLinkedList) *list);
+#endif
+KEYED(KeyFrequency) *KEYED(findXMostFrequentDLL)(KEYED(DoublyLinkedList) *list, int X, int dataSize);
+KEYED(KeyFrequency) *KEYED(findXMostFrequentMultiDLL)(KEYED(DoublyLinkedList) *list, int *Xs, int count);
+
+void KEYED(insertDataDLL)(KEYED(DoublyLinkedList) *list, KEY_TYPE *dataset, int dataSize); // Data Management Functions
+
+KEYED(WindowedDLL) *KEYED(createWindowedDLL)(int window); // Sliding-window functions
+void KEYED(destroyWindowedDLL)(KEYED(WindowedDLL) *window);
+void KEYED(insertWindowedDLL)(KEYED(WindowedDLL) *window, KEY_TYPE key);
+KEY_TYPE KEYED(findMinWindowedDLL)(KEYED(WindowedDLL) *window);
+KEY_TYPE KEYED(findMaxWindowedDLL)(KEYED(WindowedDLL) *window);
+#ifdef KEY_SUM
+double KEYED(calculateAverageWindowedDLL)(KEYED(WindowedDLL) *window);
+#endif
+KEYED(KeyFrequency) *KEYED(findXMostFrequentWindowedDLL)(KEYED(WindowedDLL) *window, int X);
+void KEYED(insertDataWindowedDLL)(KEYED(WindowedDLL) *window, KEY_TYPE *dataset, int dataSize);
+
+#endif /* KEY_TYPE */
@@ -0,0 +1,212 @@
+#ifndef KEY_TYPE
+#include "freq.h"
+#include "main.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Instantiate the code after #else once per key type
+#define KEYED_TEMPLATE "freq.c"
+#include "keys.inc"
+#undef KEYED_TEMPLATE
+
+#else /* Instantiated once per key type by keys.inc */
+
+// Helper function to hash a key into the slot table
+static int KEYED(hashKey)(KEYED(FrequencyTable) *table, KEY_TYPE key)
+{
+    unsigned int h = KEY_HASH(key) * 2654435761u;
+    h ^= h >> 16;
+    return (int)(h & (unsigned int)table->slotMask);
+}
+
+// Function to create an empty Frequency Table holding at most `capacity` keys
+KEYED(FrequencyTable) *KEYED(createFrequencyTable)(int capacity)
+{
+    KEYED(FrequencyTable) *table = malloc(sizeof(KEYED(FrequencyTable)));
+    int slotCount = 2;
+    while (slotCount / 2 < capacity && slotCount <= INT_MAX / 2)
+    {
+        slotCount *= 2;
+    }
+
+    table->items = malloc(capacity * sizeof(KEYED(KeyFrequency)));
+    table->itemSlots = malloc(capacity * sizeof(int));
+    table->bounds = calloc(capacity + 2, sizeof(int));
+    table->slots = malloc(slotCount * sizeof(int));
+    for (int i = 0; i < slotCount; i++)
+    {
+        table->slots[i] = -1;
+    }
+    table->capacity = capacity;
+    table->slotMask = slotCount - 1;
+    table->size = 0;
+    return table;
+}
+
+// Function to destroy the Frequency Table and free memory
+void KEYED(destroyFrequencyTable)(KEYED(FrequencyTable) *table)
+{
+    if (table == NULL)
+        return;
+
+    free(table->items);
+    free(table->itemSlots);
+    free(table->bounds);
+    free(table->slots);
+    free(table);
+}
+
+// Helper function to find the slot holding a key, or the empty slot where it belongs
+static int KEYED(findSlot)(KEYED(FrequencyTable) *table, KEY_TYPE key)
+{
+    int slot = KEYED(hashKey)(table, key);
+    compare();
+    while (table->slots[slot] != -1)
+    {
+        compare();
+        if (KEY_EQUAL(table->items[table->slots[slot]].key, key))
+            return slot;
+        slot = (slot + 1) & table->slotMask;
+        compare();
+    }
+    return slot;
+}
+
+// Helper function to swap two entries and keep the slot table pointing at them
+static void KEYED(swapItems)(KEYED(FrequencyTable) *table, int i, int j)
+{
+    if (i == j)
+        return;
+
+    KEYED(KeyFrequency) item = table->items[i];
+    table->items[i] = table->items[j];
+    table->items[j] = item;
+
+    int slot = table->itemSlots[i];
+    table->itemSlots[i] = table->itemSlots[j];
+    table->itemSlots[j] = slot;
+
+    table->slots[table->itemSlots[i]] = i;
+    table->slots[table->itemSlots[j]] = j;
+}
+
+// Helper function to clear a slot, shifting back the probe chain that follows it
+static void KEYED(removeSlot)(KEYED(FrequencyTable) *table, int slot)
+{
+    table->slots[slot] = -1;
+    int hole = slot;
+    int next = (slot + 1) & table->slotMask;
+
+    while (table->slots[next] != -1)
+    {
+        int home = KEYED(hashKey)(table, table->items[table->slots[next]].key);
+        bool movable = (next > hole) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable)
+        {
+            table->slots[hole] = table->slots[next];
+            table->itemSlots[table->slots[hole]] = hole;
+            table->slots[next] = -1;
+            hole = next;
+        }
+        next = (next + 1) & table->slotMask;
+    }
+}
+
+// Function to increment the frequency of a key, returning its new frequency (-1 if the table is full)
+int KEYED(incrementFrequency)(KEYED(FrequencyTable) *table, KEY_TYPE key)
+{
+    int slot = KEYED(findSlot)(table, key);
+
+    compare();
+    if (table->slots[slot] == -1)
+    {
+        compare();
+        if (table->size == table->capacity)
+            return -1;
+
+        int index = table->size++;
+        KEYED(KeyFrequency) newKey = {key, 0};
+        table->items[index] = newKey;
+        table->itemSlots[index] = slot;
+        table->slots[slot] = index;
+    }
+
+    int index = table->slots[slot];
+    int frequency = table->items[index].frequency;
+    compare();
+    if (frequency == table->capacity)
+        return frequency;
+
+    // Move the entry to the front of its frequency block, then grow the block above it
+    int first = table->bounds[frequency + 1];
+    KEYED(swapItems)(table, index, first);
+    table->bounds[frequency + 1]++;
+    table->items[first].frequency = frequency + 1;
+
+    return frequency + 1;
+}
+
+// Function to decrement the frequency of a key, returning its new frequency (-1 if absent)
+int KEYED(decrementFrequency)(KEYED(FrequencyTable) *table, KEY_TYPE key)
+{
+    int slot = KEYED(findSlot)(table, key);
+
+    compare();
+    if (table->slots[slot] == -1)
+        return -1;
+
+    // Move the entry to the back of its frequency block, then shrink the block
+    int index = table->slots[slot];
+    int frequency = table->items[index].frequency;
+    int last = table->bounds[frequency] - 1;
+    KEYED(swapItems)(table, index, last);
+    table->bounds[frequency]--;
+    table->items[last].frequency = frequency - 1;
+
+    // Keys that drop to zero are always the last entry
+    compare();
+    if (frequency == 1)
+    {
+        KEYED(removeSlot)(table, table->itemSlots[last]);
+        table->size--;
+    }
+
+    return frequency - 1;
+}
+
+// Function to get the current frequency of a key
+int KEYED(getFrequency)(KEYED(FrequencyTable) *table, KEY_TYPE key)
+{
+    int slot = KEYED(findSlot)(table, key);
+
+    compare();
+    if (table->slots[slot] == -1)
+        return 0;
+
+    return table->items[table->slots[slot]].frequency;
+}
+
+// Function to find the X most frequent keys in the Frequency Table
+KEYED(KeyFrequency) *KEYED(findXMostFrequentTable)(KEYED(FrequencyTable) *table, int X)
+{
+    compare();
+    if (table == NULL || X <= 0)
+    {
+        return NULL;
+    }
+
+    KEYED(KeyFrequency) *result = calloc(X, sizeof(KEYED(KeyFrequency)));
+
+    // Entries are already ordered by frequency, so the answer is a prefix
+    compare();
+    for (int i = 0; i < X && i < table->size; i++)
+    {
+        result[i] = table->items[i];
+        compare();
+    }
+
+    return result;
+}
+
+#endif /* KEY_TYPE */
@@ -0,0 +1,42 @@
+#ifndef KEY_TYPE
+#ifndef FREQ_H
+#define FREQ_H
+
+#include "keys.h"
+
+// Declare the types and functions after #else once per key type
+#define KEYED_TEMPLATE "freq.h"
+#include "keys.inc"
+#undef KEYED_TEMPLATE
+
+#endif /* FREQ_H */
+#else /* Instantiated once per key type by keys.inc */
+
+// Structure to store key-frequency pairs
+typedef struct KEYED(KeyFrequency)
+{
+    KEY_TYPE key;
+    int frequency;
+} KEYED(KeyFrequency);
+
+// Frequency table that keeps its entries sorted by frequency (descending)
+typedef struct KEYED(FrequencyTable)
+{
+    KEYED(KeyFrequency) *items; // Entries sorted by frequency, highest first
+    int *itemSlots;             // Hash slot that points at each entry
+    int *bounds;                // bounds[f] = number of entries with frequency >= f
+    int *slots;                 // Open-addressing hash from key to entry index (-1 = empty)
+    int capacity;
+    int slotMask;
+    int size;
+} KEYED(FrequencyTable);
+
+KEYED(FrequencyTable) *KEYED(createFrequencyTable)(int capacity); // Core ADT functions
+void KEYED(destroyFrequencyTable)(KEYED(FrequencyTable) *table);
+int KEYED(incrementFrequency)(KEYED(FrequencyTable) *table, KEY_TYPE key);
+int KEYED(decrementFrequency)(KEYED(FrequencyTable) *table, KEY_TYPE key);
+int KEYED(getFrequency)(KEYED(FrequencyTable) *table, KEY_TYPE key);
+
+KEYED(KeyFrequency) *KEYED(findXMostFrequentTable)(KEYED(FrequencyTable) *table, int X); // Statistical functions
+
+#endif /* KEY_TYPE */
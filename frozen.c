@@ -0,0 +1,117 @@
+#include "frozen.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CACHE_LINE_KEYS 16 // Keys per 64-byte cache line
+
+// Helper function to lay out sorted keys in Eytzinger order by an in-order walk of the implicit tree
+void fillFrozenAVL(FrozenAVL *frozen, int *sorted, int *next, int slot)
+{
+    if (slot <= frozen->size)
+    {
+        fillFrozenAVL(frozen, sorted, next, 2 * slot);
+        frozen->keys[slot] = sorted[*next];
+        frozen->ranks[slot] = *next;
+        (*next)++;
+        fillFrozenAVL(frozen, sorted, next, 2 * slot + 1);
+    }
+}
+
+// Function to create an immutable, implicit-layout snapshot of the AVL Tree
+FrozenAVL *freezeAVL(AVLTree *tree)
+{
+    FrozenAVL *frozen = malloc(sizeof(FrozenAVL));
+    frozen->size = tree->root ? tree->root->size : 0;
+
+    // Cache-line aligned so that the 16 descendants four levels down share one line
+    size_t bytes = ((size_t)(frozen->size + 1) * sizeof(int) + 63) / 64 * 64;
+    frozen->keys = aligned_alloc(64, bytes);
+    frozen->ranks = malloc((frozen->size + 1) * sizeof(int));
+
+    int *sorted = malloc((frozen->size + 1) * sizeof(int));
+    copyKeysAVL(tree, sorted);
+    int next = 0;
+    fillFrozenAVL(frozen, sorted, &next, 1);
+    free(sorted);
+
+    return frozen;
+}
+
+// Function to destroy the snapshot and free memory
+void destroyFrozenAVL(FrozenAVL *frozen)
+{
+    free(frozen->keys);
+    free(frozen->ranks);
+    free(frozen);
+}
+
+// Helper function to find the slot of the first key not ordered before `key` (0 if none).
+// Keys smaller than `key` (or <= with inclusive) are skipped; the descent has no data-dependent branch.
+int findBoundFrozenAVL(FrozenAVL *frozen, int key, bool inclusive)
+{
+    int slot = 1;
+
+    compare();
+    while (slot <= frozen->size)
+    {
+        __builtin_prefetch(frozen->keys + (size_t)CACHE_LINE_KEYS * slot);
+        compare();
+        slot = 2 * slot + (inclusive ? frozen->keys[slot] <= key : frozen->keys[slot] < key);
+        compare();
+    }
+
+    // Undo the trailing right turns plus the last left turn to reach the bound
+    return slot >> __builtin_ffs(~slot);
+}
+
+// Function to check whether a key is in the snapshot
+bool searchFrozenAVL(FrozenAVL *frozen, int key)
+{
+    int slot = findBoundFrozenAVL(frozen, key, false);
+    return slot != 0 && frozen->keys[slot] == key;
+}
+
+// Function to find the minimum value in the snapshot (the leftmost slot)
+int findMinFrozenAVL(FrozenAVL *frozen)
+{
+    compare();
+    if (frozen->size == 0)
+    {
+        printf("Tree is empty.\n");
+        return -1;
+    }
+
+    return frozen->keys[1 << (31 - __builtin_clz(frozen->size))];
+}
+
+// Function to find the maximum value in the snapshot (the rightmost slot)
+int findMaxFrozenAVL(FrozenAVL *frozen)
+{
+    compare();
+    if (frozen->size == 0)
+    {
+        printf("Tree is empty.\n");
+        return -1;
+    }
+
+    return frozen->keys[(1 << (31 - __builtin_clz(frozen->size + 1))) - 1];
+}
+
+// Function to count the keys in the snapshot that are smaller than `key`
+int rankFrozenAVL(FrozenAVL *frozen, int key)
+{
+    int slot = findBoundFrozenAVL(frozen, key, false);
+    return slot != 0 ? frozen->ranks[slot] : frozen->size;
+}
+
+// Function to count the keys in the snapshot within [low, high]
+int countRangeFrozenAVL(FrozenAVL *frozen, int low, int high)
+{
+    compare();
+    if (low > high)
+        return 0;
+
+    int upper = findBoundFrozenAVL(frozen, high, true);
+    int upperRank = upper != 0 ? frozen->ranks[upper] : frozen->size;
+    return upperRank - rankFrozenAVL(frozen, low);
+}
@@ -0,0 +1,24 @@
+#ifndef FROZEN_H
+#define FROZEN_H
+
+#include "avl.h"
+#include <stdbool.h>
+
+// Immutable snapshot of an AVL Tree in Eytzinger (BFS) order
+typedef struct FrozenAVL
+{
+    int *keys;  // 1-based: the children of slot k are slots 2k and 2k + 1
+    int *ranks; // In-order position of the key in each slot
+    int size;
+} FrozenAVL;
+
+FrozenAVL *freezeAVL(AVLTree *tree); // Core ADT functions
+void destroyFrozenAVL(FrozenAVL *frozen);
+bool searchFrozenAVL(FrozenAVL *frozen, int key);
+
+int findMinFrozenAVL(FrozenAVL *frozen); // Statistical functions
+int findMaxFrozenAVL(FrozenAVL *frozen);
+int rankFrozenAVL(FrozenAVL *frozen, int key);
+int countRangeFrozenAVL(FrozenAVL *frozen, int low, int high);
+
+#endif /* FROZEN_H */
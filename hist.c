@@ -0,0 +1,102 @@
+#include "hist.h"
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Function to create an empty Latency Histogram
+LatencyHistogram *createLatencyHistogram()
+{
+    return calloc(1, sizeof(LatencyHistogram));
+}
+
+// Function to destroy the Latency Histogram and free memory
+void destroyLatencyHistogram(LatencyHistogram *histogram)
+{
+    free(histogram);
+}
+
+// Helper function to map a value to its bucket: exact below HISTOGRAM_SUB_BUCKETS, then
+// HISTOGRAM_SUB_BUCKETS / 2 linear steps per power of two
+int findHistogramIndex(unsigned long long value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return (int)value;
+
+    int shift = 63 - __builtin_clzll(value) - 6; // 6 = log2(HISTOGRAM_SUB_BUCKETS / 2)
+    int subBucket = (int)(value >> shift);        // In [HISTOGRAM_SUB_BUCKETS / 2, HISTOGRAM_SUB_BUCKETS)
+    return HISTOGRAM_SUB_BUCKETS + (shift - 1) * (HISTOGRAM_SUB_BUCKETS / 2) + subBucket -
+           HISTOGRAM_SUB_BUCKETS / 2;
+}
+
+// Helper function to get the midpoint of the values that share a bucket
+unsigned long long findHistogramValue(int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS)
+        return (unsigned long long)index;
+
+    int shift = (index - HISTOGRAM_SUB_BUCKETS) / (HISTOGRAM_SUB_BUCKETS / 2) + 1;
+    int subBucket = (index - HISTOGRAM_SUB_BUCKETS) % (HISTOGRAM_SUB_BUCKETS / 2) + HISTOGRAM_SUB_BUCKETS / 2;
+    return ((unsigned long long)subBucket << shift) + (1ULL << shift) / 2;
+}
+
+// Function to record one latency sample
+void recordLatency(LatencyHistogram *histogram, unsigned long long ticks)
+{
+    histogram->counts[findHistogramIndex(ticks)]++;
+    histogram->total++;
+    if (ticks > histogram->max)
+        histogram->max = ticks;
+}
+
+// Function to find the latency at a percentile (0-100) of the recorded samples
+unsigned long long findPercentileLatency(LatencyHistogram *histogram, double percentile)
+{
+    if (histogram->total == 0)
+        return 0;
+
+    unsigned long long rank = (unsigned long long)(percentile / 100.0 * histogram->total + 0.5);
+    rank = rank < 1 ? 1 : rank;
+    unsigned long long seen = 0;
+    for (int i = 0; i < HISTOGRAM_SIZE; i++)
+    {
+        seen += histogram->counts[i];
+        if (seen >= rank)
+        {
+            unsigned long long value = findHistogramValue(i);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
+
+// Function to read a low-overhead timestamp (TSC cycles on x86, nanoseconds elsewhere)
+unsigned long long readTimestamp()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+// Function to measure how many nanoseconds one timestamp tick lasts
+double calibrateNanosecondsPerTick()
+{
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned long long startTicks = readTimestamp();
+    double elapsed;
+
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (now.tv_sec - start.tv_sec) * 1e9 + (now.tv_nsec - start.tv_nsec);
+    } while (elapsed < 10e6);
+
+    return elapsed / (double)(readTimestamp() - startTicks);
+}
@@ -0,0 +1,24 @@
+#ifndef HIST_H
+#define HIST_H
+
+#define HISTOGRAM_SUB_BUCKETS 128 // Values within a power of two are split this finely (< 1% error)
+#define HISTOGRAM_SIZE (HISTOGRAM_SUB_BUCKETS + 57 * (HISTOGRAM_SUB_BUCKETS / 2))
+
+// Log-linear (HDR-style) histogram of latencies in timestamp ticks
+typedef struct LatencyHistogram
+{
+    unsigned long long counts[HISTOGRAM_SIZE];
+    unsigned long long total;
+    unsigned long long max;
+} LatencyHistogram;
+
+LatencyHistogram *createLatencyHistogram(); // Core ADT functions
+void destroyLatencyHistogram(LatencyHistogram *histogram);
+void recordLatency(LatencyHistogram *histogram, unsigned long long ticks);
+
+unsigned long long findPercentileLatency(LatencyHistogram *histogram, double percentile); // Statistical functions
+
+unsigned long long readTimestamp(); // Timing functions
+double calibrateNanosecondsPerTick();
+
+#endif /* HIST_H */
@@ -0,0 +1,47 @@
+#ifndef KEYS_H
+#define KEYS_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Fixed-length string key, compared bytewise
+typedef struct Key16
+{
+    char bytes[16];
+} Key16;
+
+// Names a type or function of the current key type's instantiation, e.g. KEYED(insertAVL) is insertAVLInt64.
+// The int instantiation has an empty suffix, so it keeps the plain names (insertAVL, AVLTree, KeyFrequency, ...).
+#define KEYED_PASTE(name, suffix) name##suffix
+#define KEYED_EXPAND(name, suffix) KEYED_PASTE(name, suffix)
+#define KEYED(name) KEYED_EXPAND(name, KEY_SUFFIX)
+
+// Helper function to fold a 64-bit key into a hash
+static inline unsigned int hashInt64(int64_t key)
+{
+    uint64_t bits = (uint64_t)key;
+    return (unsigned int)(bits ^ (bits >> 32));
+}
+
+// Helper function to hash a double by its bits, with 0.0 and -0.0 hashing alike since they compare equal
+static inline unsigned int hashDouble(double key)
+{
+    uint64_t bits;
+    if (key == 0)
+        key = 0;
+    memcpy(&bits, &key, sizeof(bits));
+    return (unsigned int)(bits ^ (bits >> 32));
+}
+
+// Helper function to hash a string key (FNV-1a)
+static inline unsigned int hashKey16(Key16 key)
+{
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(key.bytes); i++)
+    {
+        hash = (hash ^ (unsigned char)key.bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+#endif /* KEYS_H */
@@ -1,21 +1,73 @@
+// Build: gcc -O2 *.c -o bench -pthread (older glibc only links POSIX threads with -pthread)
+#define _GNU_SOURCE // sched_setaffinity
 #include "avl.h"
 #include "dll.h"
+#include "frozen.h"
+#include "hist.h"
+#include "keys.h"
+#include <sched.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/wait.h>
 #include <time.h>
+#include <unistd.h>
 
 #define MAX_DATASIZE 100000
+#define MAX_SWEEP_DATASIZE 100000000
+#define MAX_FREEZE_DATASIZE 1000000000 // Frozen slots reach 2n + 1 and the benchmark keys 2n, both ints
+#define MAX_SWEEP_POINTS 64
+#define SWEEP_OPERATIONS 12
+#define SWEEP_TIME_LIMIT 10.0
+#define SWEEP_MIN_QUERY_TIME 0.001
+#define SWEEP_FIT_MARGIN 0.5 // A worse model is only reported if its residual is below this share of the expected one
+#define ISOLATION_RUNS 5
+#define ISOLATION_OPERATIONS 6
+
+// Benchmark modes selectable after the dataset arguments
+const char *modes[] = {"window",  "parallel", "setops", "batch",  "sweep",   "latency",
+                       "topk",    "compact",  "keys",   "freeze", "isolate", "isolate-flush"};
+
+// Complexity models fitted by the scaling sweep, from best to worst
+enum
+{
+    MODEL_CONSTANT,
+    MODEL_LOG,
+    MODEL_LINEAR,
+    MODEL_LINEARITHMIC,
+    MODEL_QUADRATIC,
+    MODEL_COUNT
+};
+const char *modelNames[] = {"O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)"};
+
+// Operations covered by the scaling sweep and the growth each one should have
+const char *sweepOperations[SWEEP_OPERATIONS] = {"AVL insert",  "DLL insert",  "AVL min",    "DLL min",
+                                                 "AVL max",     "DLL max",     "AVL average", "DLL average",
+                                                 "AVL top 10",  "DLL top 10",  "AVL top 50", "DLL top 50"};
+const int sweepExpected[SWEEP_OPERATIONS] = {MODEL_LINEARITHMIC, MODEL_LINEAR,       MODEL_LOG,          MODEL_LINEAR,
+                                             MODEL_LOG,          MODEL_LINEAR,       MODEL_LINEAR,       MODEL_LINEAR,
+                                             MODEL_LINEARITHMIC, MODEL_LINEARITHMIC, MODEL_LINEARITHMIC,
+                                             MODEL_LINEARITHMIC};
 
 // Global variable to count comparisons
 unsigned long long comparisonCount = 0;
 
+// Global variable to count AVL rotations
+unsigned long long rotationCount = 0;
+
 // Function that increments comparisonCount (insert just before comparison)
 void compare()
 {
     comparisonCount++;
 }
 
+// Function that increments rotationCount (insert in every performed rotation)
+void rotate()
+{
+    rotationCount++;
+}
+
 // Helper function to print the X most repeated values in the tree
 void printMostFrequent(KeyFrequency *result, int X)
 {
@@ -25,7 +77,8 @@ void printMostFrequent(KeyFrequency *result, int X)
         return;
     }
 
-    for (int i = 0; (i < X && result[i].key != 0); i++)
+    // Unused entries have frequency 0; key 0 is a valid key
+    for (int i = 0; (i < X && result[i].frequency != 0); i++)
     {
         if ((i != 0) && (i % 10 == 0))
         {
@@ -35,58 +88,1362 @@ void printMostFrequent(KeyFrequency *result, int X)
     }
 }
 
-// Helper function to perform bubble sort on array
-void bubbleSort(int *array, int arrSize)
+// Function to generate an ordered or unordered dataset
+int *generateData(const char *orderType, int dataSize)
+{
+    int *dataset = malloc(dataSize * sizeof(int));
+
+    srand(time(NULL));
+    for (int i = 0; i < dataSize; i++)
+    {
+        int value = rand() % dataSize + 1;
+        dataset[i] = value;
+    }
+
+    if (strcmp(orderType, "ordered") == 0)
+    {
+        qsort(dataset, dataSize, sizeof(int), compareKeysAVL);
+    }
+
+    return dataset;
+}
+
+// Function to benchmark sliding-window statistics against rescanning the window
+void benchmarkWindow(int *dataset, int dataSize, int window)
+{
+    // A window longer than the stream never evicts, so it only has to hold the whole dataset
+    if (window > dataSize)
+        window = dataSize;
+    WindowedDLL *windowedDLL = createWindowedDLL(window);
+    WindowedAVL *windowedAVL = createWindowedAVL(window);
+    int queries = dataSize < 100 ? dataSize : 100;
+    double dllTimeInsertion = 0, avlTimeInsertion = 0;
+    double timeMin = 0, timeMax = 0, timeAverage = 0, timeFrequent = 0;
+    double rescanTimeMin = 0, rescanTimeMax = 0, rescanTimeAverage = 0, rescanTimeFrequent = 0;
+    double timeRange = 0, timePercentile = 0;
+
+    // Stream the dataset in `queries` even batches, querying both the window and a rescan of it after each
+    for (int query = 0; query < queries; query++)
+    {
+        int i = (int)((long long)dataSize * query / queries);
+        int batch = (int)((long long)dataSize * (query + 1) / queries) - i;
+        clock_t start = clock();
+        insertDataWindowedDLL(windowedDLL, dataset + i, batch);
+        dllTimeInsertion += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        insertDataWindowedAVL(windowedAVL, dataset + i, batch);
+        avlTimeInsertion += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        findMinWindowedDLL(windowedDLL);
+        timeMin += (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        findMinDLL(windowedDLL->list);
+        rescanTimeMin += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        findMaxWindowedDLL(windowedDLL);
+        timeMax += (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        findMaxDLL(windowedDLL->list);
+        rescanTimeMax += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        calculateAverageWindowedDLL(windowedDLL);
+        timeAverage += (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        calculateAverageDLL(windowedDLL->list);
+        rescanTimeAverage += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        free(findXMostFrequentWindowedDLL(windowedDLL, 10));
+        timeFrequent += (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        free(findXMostFrequentDLL(windowedDLL->list, 10, windowedDLL->count));
+        rescanTimeFrequent += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+        start = clock();
+        countRangeWindowedAVL(windowedAVL, 0, dataSize / 2);
+        timeRange += (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        findPercentileWindowedAVL(windowedAVL, 99);
+        timePercentile += (double)(clock() - start) / CLOCKS_PER_SEC;
+    }
+
+    // Print the final state of the window
+    printf("Window: last %d insertions\n\n", window);
+    printf("Windowed Doubly-Linked List:\n");
+    printf("%-25s%d\n", "  - Minimum:", findMinWindowedDLL(windowedDLL));
+    printf("%-25s%d\n", "  - Maximum:", findMaxWindowedDLL(windowedDLL));
+    printf("%-25s%.1f\n", "  - Average:", calculateAverageWindowedDLL(windowedDLL));
+    printf("%-25s", "  - 10 most frequent:");
+    KeyFrequency *mostFrequent = findXMostFrequentWindowedDLL(windowedDLL, 10);
+    printMostFrequent(mostFrequent, 10);
+    free(mostFrequent);
+    printf("\n\nWindowed AVL Tree:\n");
+    printf("%-25s%d\n", "  - Distinct keys:", windowedAVL->frequencies->size);
+    printf("%-25s%d\n", "  - Keys in [0, n/2]:", countRangeWindowedAVL(windowedAVL, 0, dataSize / 2));
+    printf("%-25s%d\n", "  - p50:", findPercentileWindowedAVL(windowedAVL, 50));
+    printf("%-25s%d\n", "  - p90:", findPercentileWindowedAVL(windowedAVL, 90));
+    printf("%-25s%d\n\n", "  - p99:", findPercentileWindowedAVL(windowedAVL, 99));
+
+    // Print the time benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("| %-30sExecution Time over %3d queries (s)%-28s |\n", "", queries, "");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Operation", "Windowed", "Window rescan", "Windowed/Rescan");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |\n", "Find min", timeMin, rescanTimeMin, timeMin / rescanTimeMin);
+    printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |\n", "Find max", timeMax, rescanTimeMax, timeMax / rescanTimeMax);
+    printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |\n", "Calculate average", timeAverage, rescanTimeAverage,
+           timeAverage / rescanTimeAverage);
+    printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |\n", "Find 10 most frequent", timeFrequent, rescanTimeFrequent,
+           timeFrequent / rescanTimeFrequent);
+    printf("| %-24s | %-20.6f | %-20s | %-20s |\n", "Range count (AVL)", timeRange, "-", "-");
+    printf("| %-24s | %-20.6f | %-20s | %-20s |\n", "Find p99 (AVL)", timePercentile, "-", "-");
+    printf("| %-24s | %-20.6f | %-20s | %-20s |\n", "Insert data (DLL)", dllTimeInsertion, "-", "-");
+    printf("| %-24s | %-20.6f | %-20s | %-20s |\n", "Insert data (AVL)", avlTimeInsertion, "-", "-");
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    destroyWindowedDLL(windowedDLL);
+    destroyWindowedAVL(windowedAVL);
+}
+
+// Function to read a monotonic wall clock in seconds (clock() sums CPU time across threads)
+double wallTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Function to benchmark the parallel AVL build against serial insertion and against itself on one thread
+void benchmarkParallelBuild(int *dataset, int dataSize, int maxThreads)
 {
-    for (int i = 0; i < arrSize - 1; i++)
+    AVLTree *serialTree = createAVLTree();
+    double start = wallTime();
+    insertDataAVL(serialTree, dataset, dataSize);
+    double serialTime = wallTime() - start;
+    int serialSize = serialTree->root ? serialTree->root->size : 0;
+    destroyAVLTree(serialTree);
+
+    // The same partition, sort and bulk-build steps on the calling thread, which thread scaling is measured against
+    AVLTree *bulkTree = createAVLTree();
+    start = wallTime();
+    insertDataAVLParallel(bulkTree, dataset, dataSize, 1);
+    double bulkTime = wallTime() - start;
+    int bulkSize = bulkTree->root ? bulkTree->root->size : 0;
+    destroyAVLTree(bulkTree);
+
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("| %-34sParallel AVL Build Time (s)%-32s |\n", "", "");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-14s | %-14s | %-16s | %-13s |\n", "Build", "Time", "Thread scaling", "vs insertDataAVL",
+           "Keys");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-14.6f | %-14s | %-16.2f | %-13d |\n", "Serial insertDataAVL", serialTime, "-", 1.0,
+           serialSize);
+    printf("| %-24s | %-14.6f | %-14.2f | %-16.2f | %-13d |\n", "Bulk build, 1 thread", bulkTime, 1.0,
+           serialTime / bulkTime, bulkSize);
+
+    // Double the thread count each round, always finishing with maxThreads itself
+    if (maxThreads > MAX_BUILD_THREADS)
+        maxThreads = MAX_BUILD_THREADS;
+    for (int threads = 2; threads <= maxThreads;
+         threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2)
     {
-        for (int j = 0; j < arrSize - i - 1; j++)
+        AVLTree *tree = createAVLTree();
+        start = wallTime();
+        insertDataAVLParallel(tree, dataset, dataSize, threads);
+        double parallelTime = wallTime() - start;
+
+        char label[32];
+        snprintf(label, sizeof(label), "Parallel, %d threads", threads);
+        printf("| %-24s | %-14.6f | %-14.2f | %-16.2f | %-13d |\n", label, parallelTime, bulkTime / parallelTime,
+               serialTime / parallelTime, tree->root ? tree->root->size : 0);
+        destroyAVLTree(tree);
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+}
+
+// Helper function to build an AVL Tree from the first `count` keys of a dataset
+AVLTree *buildAVLTree(int *dataset, int count)
+{
+    AVLTree *tree = createAVLTree();
+    insertDataAVL(tree, dataset, count);
+    return tree;
+}
+
+// Helper function to print one row of the set operation table and check both results agree
+void printSetOperationRow(const char *operation, int ratio, double naiveTime, double joinTime, AVLTree *naive,
+                          AVLTree *joined)
+{
+    char label[32];
+    snprintf(label, sizeof(label), "%s, n/m=%d", operation, ratio);
+    int naiveSize = naive->root ? naive->root->size : 0;
+    int joinedSize = joined->root ? joined->root->size : 0;
+    printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |%s\n", label, naiveTime, joinTime, naiveTime / joinTime,
+           naiveSize == joinedSize ? "" : " size mismatch");
+}
+
+// Function to benchmark join-based set operations against key-by-key re-insertion
+void benchmarkSetOperations(int *dataset, int dataSize, int maxRatio)
+{
+    int *others = malloc(dataSize * sizeof(int));
+    int *keys = malloc(dataSize * sizeof(int));
+    for (int i = 0; i < dataSize; i++)
+    {
+        others[i] = rand() % dataSize + 1;
+    }
+
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("| %-33sSet Operation Time (s)%-38s |\n", "", "");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Operation", "Re-insertion", "Split/join", "Speedup");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+
+    for (int ratio = 1; ratio <= maxRatio && dataSize / ratio > 0; ratio *= 2)
+    {
+        int otherSize = dataSize / ratio;
+        AVLTree *other = buildAVLTree(others, otherSize);
+        int keyCount = copyKeysAVL(other, keys);
+        destroyAVLTree(other);
+
+        // Union: insert every key of the smaller tree vs. one union
+        AVLTree *naive = buildAVLTree(dataset, dataSize);
+        double start = wallTime();
+        for (int i = 0; i < keyCount; i++)
+        {
+            insertAVL(naive, keys[i]);
+        }
+        double naiveTime = wallTime() - start;
+        AVLTree *joined = buildAVLTree(dataset, dataSize);
+        other = buildAVLTree(others, otherSize);
+        start = wallTime();
+        unionAVL(joined, other);
+        double joinTime = wallTime() - start;
+        printSetOperationRow("Union", ratio, naiveTime, joinTime, naive, joined);
+        destroyAVLTree(naive);
+        destroyAVLTree(joined);
+        destroyAVLTree(other);
+
+        // Intersection: insert the hits of the smaller tree into a new tree that replaces the larger one
+        AVLTree *tree = buildAVLTree(dataset, dataSize);
+        naive = createAVLTree();
+        start = wallTime();
+        for (int i = 0; i < keyCount; i++)
+        {
+            if (searchAVL(tree, keys[i]))
+                insertAVL(naive, keys[i]);
+        }
+        naiveTime = wallTime() - start;
+        destroyAVLTree(tree);
+        joined = buildAVLTree(dataset, dataSize);
+        other = buildAVLTree(others, otherSize);
+        start = wallTime();
+        intersectAVL(joined, other);
+        joinTime = wallTime() - start;
+        printSetOperationRow("Intersection", ratio, naiveTime, joinTime, naive, joined);
+        destroyAVLTree(naive);
+        destroyAVLTree(joined);
+        destroyAVLTree(other);
+
+        // Difference: delete every key of the smaller tree vs. one difference
+        naive = buildAVLTree(dataset, dataSize);
+        start = wallTime();
+        for (int i = 0; i < keyCount; i++)
         {
-            if (array[j] > array[j + 1])
+            deleteAVL(naive, keys[i]);
+        }
+        naiveTime = wallTime() - start;
+        joined = buildAVLTree(dataset, dataSize);
+        other = buildAVLTree(others, otherSize);
+        start = wallTime();
+        differenceAVL(joined, other);
+        joinTime = wallTime() - start;
+        printSetOperationRow("Difference", ratio, naiveTime, joinTime, naive, joined);
+        destroyAVLTree(naive);
+        destroyAVLTree(joined);
+        destroyAVLTree(other);
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    free(others);
+    free(keys);
+}
+
+// Function to benchmark sorted batched insertion against insertDataAVL on three access patterns
+void benchmarkBatchInsertion(int *dataset, int dataSize, int maxBatch)
+{
+    const char *patterns[] = {"Ordered", "Nearly ordered", "Random"};
+    int *data = malloc(dataSize * sizeof(int));
+    double times[3][2][16];
+    unsigned long long comparisons[3][2][16];
+    int batchSizes[16];
+    int batchCount = 0;
+
+    for (int batch = 10; batch <= maxBatch && batchCount < 16; batch *= 10)
+    {
+        batchSizes[batchCount++] = batch;
+
+        // Stop before the next power of ten can overflow
+        if (batch > maxBatch / 10)
+            break;
+    }
+
+    for (int pattern = 0; pattern < 3; pattern++)
+    {
+        // Derive the pattern from the dataset: sorted, sorted with 1% random swaps, or shuffled
+        memcpy(data, dataset, dataSize * sizeof(int));
+        if (pattern < 2)
+            qsort(data, dataSize, sizeof(int), compareKeysAVL);
+        for (int i = 0; i < (pattern == 1 ? dataSize / 100 : pattern == 2 ? dataSize : 0); i++)
+        {
+            int j = rand() % dataSize;
+            int k = pattern == 2 ? i : rand() % dataSize;
+            int temp = data[j];
+            data[j] = data[k];
+            data[k] = temp;
+        }
+
+        for (int b = 0; b < batchCount; b++)
+        {
+            AVLTree *tree = createAVLTree();
+            comparisonCount = 0;
+            clock_t start = clock();
+            insertDataAVL(tree, data, dataSize);
+            times[pattern][0][b] = (double)(clock() - start) / CLOCKS_PER_SEC;
+            comparisons[pattern][0][b] = comparisonCount;
+            destroyAVLTree(tree);
+
+            tree = createAVLTree();
+            comparisonCount = 0;
+            start = clock();
+            for (int i = 0; i < dataSize; i += batchSizes[b])
             {
-                int temp = array[j];
-                array[j] = array[j + 1];
-                array[j + 1] = temp;
+                insertBatchAVL(tree, data + i, dataSize - i < batchSizes[b] ? dataSize - i : batchSizes[b]);
             }
+            times[pattern][1][b] = (double)(clock() - start) / CLOCKS_PER_SEC;
+            comparisons[pattern][1][b] = comparisonCount;
+            destroyAVLTree(tree);
         }
     }
+    comparisonCount = 0;
+
+    // Print the time benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("| %-37sExecution Time (s)%-38s |\n", "", "");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Workload", "insertDataAVL", "insertBatchAVL", "Speedup");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int pattern = 0; pattern < 3; pattern++)
+    {
+        for (int b = 0; b < batchCount; b++)
+        {
+            char label[32];
+            snprintf(label, sizeof(label), "%s, %d", patterns[pattern], batchSizes[b]);
+            printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |\n", label, times[pattern][0][b], times[pattern][1][b],
+                   times[pattern][0][b] / times[pattern][1][b]);
+        }
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    // Print the comparison benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("| %-36sNumber of Comparisons%-36s |\n", "", "");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Workload", "insertDataAVL", "insertBatchAVL", "Ratio");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int pattern = 0; pattern < 3; pattern++)
+    {
+        for (int b = 0; b < batchCount; b++)
+        {
+            char label[32];
+            snprintf(label, sizeof(label), "%s, %d", patterns[pattern], batchSizes[b]);
+            printf("| %-24s | %-20lli | %-20lli | %-20.2Lf |\n", label, comparisons[pattern][0][b],
+                   comparisons[pattern][1][b], comparisons[pattern][0][b] / (long double)comparisons[pattern][1][b]);
+        }
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    free(data);
 }
 
-// Function to generate an ordered or unordered dataset
-int *generateData(const char *orderType, int dataSize)
+// Helper function to print a title centered in a table row
+void printTableTitle(const char *title)
 {
-    int *dataset = malloc(dataSize * sizeof(int));
+    int padding = (93 - (int)strlen(title)) / 2;
+    printf("| %*s%-*s |\n", padding, "", 93 - padding, title);
+}
+
+// Helper function to compute log2(x) for a positive, normal x without depending on libm
+double binaryLog(double x)
+{
+    // Split x into 2^exponent * mantissa with the mantissa in [1, 2)
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    int exponent = (int)((bits >> 52) & 0x7ff) - 1023;
+    bits = (bits & ((1ULL << 52) - 1)) | (1023ULL << 52);
+    double mantissa;
+    memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    // ln(m) = 2 * atanh(z) with z = (m - 1) / (m + 1) <= 1/3, whose series converges quickly
+    double z = (mantissa - 1) / (mantissa + 1);
+    double term = z, sum = 0;
+    for (int k = 1; k < 30; k += 2)
+    {
+        sum += term / k;
+        term *= z * z;
+    }
+    return exponent + 2 * sum / 0.69314718055994531;
+}
+
+// Helper function to evaluate a complexity model at size n
+double evaluateModel(int model, double n)
+{
+    switch (model)
+    {
+    case MODEL_CONSTANT:
+        return 1.0;
+    case MODEL_LOG:
+        return binaryLog(n + 1);
+    case MODEL_LINEAR:
+        return n;
+    case MODEL_LINEARITHMIC:
+        return n * binaryLog(n + 1);
+    default:
+        return n * n;
+    }
+}
+
+// Function to fit measurements to the complexity model with the smallest log-space residual (-1 if too few points),
+// storing the residual of every model in `residuals`
+int fitComplexity(double *sizes, double *values, int count, double *residuals)
+{
+    int bestModel = -1;
+    double bestResidual = 0;
+
+    for (int model = 0; model < MODEL_COUNT; model++)
+    {
+        // With y = c * f(n), log(y / f(n)) is constant, so its variance measures the misfit
+        double sum = 0, sumSquares = 0;
+        int points = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (values[i] <= 0)
+                continue;
+            double ratio = binaryLog(values[i] / evaluateModel(model, sizes[i]));
+            sum += ratio;
+            sumSquares += ratio * ratio;
+            points++;
+        }
+        if (points < 3)
+            return -1;
+
+        double mean = sum / points;
+        double residual = sumSquares / points - mean * mean;
+        residuals[model] = residual;
+        if (bestModel == -1 || residual < bestResidual)
+        {
+            bestModel = model;
+            bestResidual = residual;
+        }
+    }
+
+    return bestModel;
+}
+
+// Helper function to check whether a fitted model is both above the allowed one and a clearly better fit than it
+bool isWorseFit(int model, int allowed, double *residuals)
+{
+    if (model <= allowed)
+        return false;
+    return residuals[model] < SWEEP_FIT_MARGIN * residuals[allowed];
+}
+
+// Helper function to run one query operation of the sweep
+void runSweepQuery(int operation, AVLTree *avlTree, DoublyLinkedList *doublyLinkedList, int dataSize)
+{
+    switch (operation)
+    {
+    case 2:
+        findMinAVL(avlTree);
+        break;
+    case 3:
+        findMinDLL(doublyLinkedList);
+        break;
+    case 4:
+        findMaxAVL(avlTree);
+        break;
+    case 5:
+        findMaxDLL(doublyLinkedList);
+        break;
+    case 6:
+        calculateAverageAVL(avlTree);
+        break;
+    case 7:
+        calculateAverageDLL(doublyLinkedList);
+        break;
+    case 8:
+        free(findXMostFrequentAVL(avlTree, 10, dataSize));
+        break;
+    case 9:
+        free(findXMostFrequentDLL(doublyLinkedList, 10, dataSize));
+        break;
+    case 10:
+        free(findXMostFrequentAVL(avlTree, 50, dataSize));
+        break;
+    default:
+        free(findXMostFrequentDLL(doublyLinkedList, 50, dataSize));
+        break;
+    }
+}
+
+// Function to run every operation over a geometric range of sizes and fit its growth
+void benchmarkSweep(int minSize, int maxSize)
+{
+    const char *orderTypes[] = {"ordered", "unordered"};
+    double sizes[MAX_SWEEP_POINTS];
+    int sizeCount = 0;
+
+    for (long long size = minSize; size <= maxSize && sizeCount < MAX_SWEEP_POINTS; size *= 2)
+    {
+        sizes[sizeCount++] = (double)size;
+    }
+
+    for (int order = 0; order < 2; order++)
+    {
+        double times[SWEEP_OPERATIONS][MAX_SWEEP_POINTS] = {{0}};
+        double comparisons[SWEEP_OPERATIONS][MAX_SWEEP_POINTS] = {{0}};
+        int points[SWEEP_OPERATIONS] = {0};
+        bool active[SWEEP_OPERATIONS];
+        for (int operation = 0; operation < SWEEP_OPERATIONS; operation++)
+        {
+            active[operation] = true;
+        }
+
+        for (int s = 0; s < sizeCount; s++)
+        {
+            int dataSize = (int)sizes[s];
+            int *dataset = generateData(orderTypes[order], dataSize);
+            AVLTree *avlTree = createAVLTree();
+            DoublyLinkedList *doublyLinkedList = createDoublyLinkedList();
+            printf("Sweeping %s n=%d\n", orderTypes[order], dataSize);
+
+            // Queries need the structure, so a structure whose insertion is over budget ends its sweep
+            for (int operation = 0; operation < SWEEP_OPERATIONS; operation++)
+            {
+                if (!active[operation] || !active[operation % 2])
+                {
+                    active[operation] = false;
+                    continue;
+                }
+
+                comparisonCount = 0;
+                double start = wallTime();
+                double elapsed;
+                if (operation == 0)
+                {
+                    insertDataAVL(avlTree, dataset, dataSize);
+                    elapsed = wallTime() - start;
+                }
+                else if (operation == 1)
+                {
+                    insertDataDLL(doublyLinkedList, dataset, dataSize);
+                    elapsed = wallTime() - start;
+                }
+                else
+                {
+                    // Repeat fast queries until the total is long enough to time reliably
+                    int repetitions = 0;
+                    do
+                    {
+                        runSweepQuery(operation, avlTree, doublyLinkedList, dataSize);
+                        repetitions++;
+                        if (repetitions == 1)
+                            comparisons[operation][s] = (double)comparisonCount;
+                        elapsed = wallTime() - start;
+                    } while (elapsed < SWEEP_MIN_QUERY_TIME);
+                    elapsed /= repetitions;
+                }
+                if (operation < 2)
+                    comparisons[operation][s] = (double)comparisonCount;
+
+                times[operation][s] = elapsed;
+                points[operation] = s + 1;
+                if (elapsed > SWEEP_TIME_LIMIT)
+                    active[operation] = false;
+            }
+            comparisonCount = 0;
+
+            destroyAVLTree(avlTree);
+            destroyDoublyLinkedList(doublyLinkedList);
+            free(dataset);
+        }
+
+        // Print the fitted models in table format
+        printf("\n");
+        printf("+-----------------------------------------------------------------------------------------------+\n");
+        char title[64];
+        snprintf(title, sizeof(title), "Scaling Sweep: %s, n = %d..%d", orderTypes[order], minSize, maxSize);
+        printTableTitle(title);
+        printf("|-----------------------------------------------------------------------------------------------|\n");
+        printf("| %-24s | %-20s | %-20s | %-20s |\n", "Operation", "Time fit", "Comparisons fit", "Expected");
+        printf("|-----------------------------------------------------------------------------------------------|\n");
+        for (int operation = 0; operation < SWEEP_OPERATIONS; operation++)
+        {
+            double timeResiduals[MODEL_COUNT], comparisonResiduals[MODEL_COUNT];
+            int timeModel = fitComplexity(sizes, times[operation], points[operation], timeResiduals);
+            int comparisonModel =
+                fitComplexity(sizes, comparisons[operation], points[operation], comparisonResiduals);
+            // Cache and allocator effects can add a log factor to the time curve alone (O(1) to O(log n), O(n) to
+            // O(n log n)), and a curve that crosses a cache boundary fits every model poorly, so only a decisively
+            // better fit is reported
+            int expected = sweepExpected[operation];
+            int timeAllowed = expected == MODEL_CONSTANT || expected == MODEL_LINEAR ? expected + 1 : expected;
+            bool worse = (comparisonModel >= 0 && isWorseFit(comparisonModel, expected, comparisonResiduals)) ||
+                         (timeModel >= 0 && isWorseFit(timeModel, timeAllowed, timeResiduals));
+            printf("| %-24s | %-20s | %-20s | %-20s |%s\n", sweepOperations[operation],
+                   timeModel < 0 ? "too few sizes" : modelNames[timeModel],
+                   comparisonModel < 0 ? "too few sizes" : modelNames[comparisonModel],
+                   modelNames[sweepExpected[operation]], worse ? " <-- worse than expected" : "");
+        }
+        printf("+-----------------------------------------------------------------------------------------------+\n");
+        printf("\n");
+    }
+}
+
+// Helper function to print the latency percentiles of one histogram in nanoseconds
+void printLatencyRow(const char *operation, LatencyHistogram *histogram, double nsPerTick, unsigned long long total)
+{
+    char label[48];
+    snprintf(label, sizeof(label), "%s (%.1f%%)", operation, total ? 100.0 * histogram->total / total : 0.0);
+    printf("| %-28s |", label);
+    double percentiles[] = {50, 90, 99, 99.9};
+    for (int i = 0; i < 4; i++)
+    {
+        printf(" %-10.0f |", findPercentileLatency(histogram, percentiles[i]) * nsPerTick);
+    }
+    printf(" %-10.0f |\n", histogram->max * nsPerTick);
+}
+
+// Function to record the latency of every individual insert and lookup
+void benchmarkLatency(int *dataset, int dataSize, int lookups)
+{
+    AVLTree *avlTree = createAVLTree();
+    DoublyLinkedList *doublyLinkedList = createDoublyLinkedList();
+    LatencyHistogram *avlInsert = createLatencyHistogram();
+    LatencyHistogram *avlInsertByRotations[3]; // An AVL insertion performs at most one double rotation
+    LatencyHistogram *dllInsert = createLatencyHistogram();
+    LatencyHistogram *avlLookup = createLatencyHistogram();
+    LatencyHistogram *timerOverhead = createLatencyHistogram();
+    for (int i = 0; i < 3; i++)
+    {
+        avlInsertByRotations[i] = createLatencyHistogram();
+    }
+    double nsPerTick = calibrateNanosecondsPerTick();
+
+    // Back-to-back timestamps show the floor that every sample includes
+    for (int i = 0; i < 10000; i++)
+    {
+        unsigned long long start = readTimestamp();
+        recordLatency(timerOverhead, readTimestamp() - start);
+    }
 
-    srand(time(NULL));
     for (int i = 0; i < dataSize; i++)
     {
-        int value = rand() % dataSize + 1;
-        dataset[i] = value;
+        rotationCount = 0;
+        unsigned long long start = readTimestamp();
+        insertAVL(avlTree, dataset[i]);
+        unsigned long long ticks = readTimestamp() - start;
+        recordLatency(avlInsert, ticks);
+        recordLatency(avlInsertByRotations[rotationCount < 2 ? rotationCount : 2], ticks);
+
+        start = readTimestamp();
+        insertDLL(doublyLinkedList, dataset[i]);
+        recordLatency(dllInsert, readTimestamp() - start);
     }
 
-    if (strcmp(orderType, "ordered") == 0)
+    for (int i = 0; i < lookups; i++)
     {
-        bubbleSort(dataset, dataSize);
+        int key = rand() % dataSize + 1;
+        unsigned long long start = readTimestamp();
+        searchAVL(avlTree, key);
+        recordLatency(avlLookup, readTimestamp() - start);
     }
+    comparisonCount = 0;
+    rotationCount = 0;
 
-    return dataset;
+    // Print the latency percentiles in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("| %-40sLatency (ns)%-41s |\n", "", "");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-28s | %-10s | %-10s | %-10s | %-10s | %-10s |\n", "Operation (share)", "p50", "p90", "p99", "p99.9",
+           "max");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printLatencyRow("AVL insert", avlInsert, nsPerTick, avlInsert->total);
+    printLatencyRow("  0 rotations", avlInsertByRotations[0], nsPerTick, avlInsert->total);
+    printLatencyRow("  1 rotation", avlInsertByRotations[1], nsPerTick, avlInsert->total);
+    printLatencyRow("  2 rotations", avlInsertByRotations[2], nsPerTick, avlInsert->total);
+    printLatencyRow("DLL insert", dllInsert, nsPerTick, dllInsert->total);
+    printLatencyRow("AVL lookup", avlLookup, nsPerTick, avlLookup->total);
+    printLatencyRow("Timer overhead", timerOverhead, nsPerTick, timerOverhead->total);
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    for (int i = 0; i < 3; i++)
+    {
+        destroyLatencyHistogram(avlInsertByRotations[i]);
+    }
+    destroyLatencyHistogram(avlInsert);
+    destroyLatencyHistogram(dllInsert);
+    destroyLatencyHistogram(avlLookup);
+    destroyLatencyHistogram(timerOverhead);
+    destroyAVLTree(avlTree);
+    destroyDoublyLinkedList(doublyLinkedList);
+}
+
+// Function to benchmark dashboard refreshes of several top-K queries, separately and with one cached query
+void benchmarkTopFrequencies(int *dataset, int dataSize, int refreshes)
+{
+    int Xs[] = {10, 50, 100, 1000};
+    int count = sizeof(Xs) / sizeof(Xs[0]);
+    const char *labels[] = {"AVL, separate calls", "AVL, multi-K cached", "DLL, separate calls", "DLL, multi-K cached"};
+    double times[4] = {0};
+    unsigned long long comparisons[4] = {0};
+
+    AVLTree *avlTree = createAVLTree();
+    DoublyLinkedList *doublyLinkedList = createDoublyLinkedList();
+    insertDataAVL(avlTree, dataset, dataSize);
+    insertDataDLL(doublyLinkedList, dataset, dataSize);
+
+    for (int variant = 0; variant < 4; variant++)
+    {
+        comparisonCount = 0;
+        double start = wallTime();
+        for (int refresh = 0; refresh < refreshes; refresh++)
+        {
+            if (variant == 0 || variant == 2)
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    free(variant == 0 ? findXMostFrequentAVL(avlTree, Xs[i], dataSize)
+                                      : findXMostFrequentDLL(doublyLinkedList, Xs[i], dataSize));
+                }
+            }
+            else
+            {
+                free(variant == 1 ? findXMostFrequentMultiAVL(avlTree, Xs, count)
+                                  : findXMostFrequentMultiDLL(doublyLinkedList, Xs, count));
+            }
+        }
+        times[variant] = wallTime() - start;
+        comparisons[variant] = comparisonCount;
+    }
+    comparisonCount = 0;
+
+    // Print the nested answers of the cached query
+    KeyFrequency *ranking = findXMostFrequentMultiDLL(doublyLinkedList, Xs, count);
+    printf("Doubly-Linked List:\n");
+    printf("%-25s", "  - 10 most frequent:");
+    printMostFrequent(ranking, 10);
+    printf("\n%-25s", "  - 50 most frequent:");
+    printMostFrequent(ranking, 50);
+    printf("\n\n");
+    free(ranking);
+
+    // Print the benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    char title[64];
+    snprintf(title, sizeof(title), "Top-10/50/100/1000 over %d refreshes", refreshes);
+    printTableTitle(title);
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Query", "Time (s)", "Per refresh (s)", "Comparisons");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int variant = 0; variant < 4; variant++)
+    {
+        printf("| %-24s | %-20.6f | %-20.6f | %-20lli |\n", labels[variant], times[variant], times[variant] / refreshes,
+               comparisons[variant]);
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    destroyAVLTree(avlTree);
+    destroyDoublyLinkedList(doublyLinkedList);
+}
+
+// Helper function to time the Doubly-Linked List traversals, averaged over several runs
+void timeTraversalsDLL(DoublyLinkedList *list, double *times)
+{
+    int repetitions = 10;
+    for (int operation = 0; operation < 3; operation++)
+    {
+        double start = wallTime();
+        for (int i = 0; i < repetitions; i++)
+        {
+            if (operation == 0)
+                findMinDLL(list);
+            else if (operation == 1)
+                findMaxDLL(list);
+            else
+                calculateAverageDLL(list);
+        }
+        times[operation] = (wallTime() - start) / repetitions;
+    }
+    comparisonCount = 0;
+}
+
+// Function to benchmark Doubly-Linked List traversal on a fragmented heap, before and after compaction
+void benchmarkCompaction(int *dataset, int dataSize, int fillers)
+{
+    const char *operations[] = {"Find min", "Find max", "Calculate average"};
+    double times[3][3];
+    double compactionTimes[2];
+
+    // Free node-sized blocks in random order so that malloc hands them back shuffled
+    void **holes = malloc(dataSize * sizeof(void *));
+    for (int i = 0; i < dataSize; i++)
+    {
+        holes[i] = malloc(sizeof(DLLNode));
+    }
+    for (int i = dataSize - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        void *temp = holes[i];
+        holes[i] = holes[j];
+        holes[j] = temp;
+    }
+    for (int i = 0; i < dataSize; i++)
+    {
+        free(holes[i]);
+    }
+    free(holes);
+
+    // Interleave live allocations of random size between consecutive nodes
+    void **live = malloc((size_t)dataSize * fillers * sizeof(void *));
+    DoublyLinkedList *list = createDoublyLinkedList();
+    for (int i = 0; i < dataSize; i++)
+    {
+        insertDLL(list, dataset[i]);
+        for (int f = 0; f < fillers; f++)
+        {
+            live[(size_t)i * fillers + f] = malloc(16 + rand() % 112);
+        }
+    }
+
+    timeTraversalsDLL(list, times[0]);
+    int fragmentedMin = findMinDLL(list);
+    double start = wallTime();
+    compactDLL(list, false);
+    compactionTimes[0] = wallTime() - start;
+    timeTraversalsDLL(list, times[1]);
+    start = wallTime();
+    compactDLL(list, true);
+    compactionTimes[1] = wallTime() - start;
+    timeTraversalsDLL(list, times[2]);
+    int compactedMin = findMinDLL(list);
+    comparisonCount = 0;
+
+    // Print the time benchmarks in table format
+    printf("Fillers per node: %d, minimum before/after compaction: %d/%d\n\n", fillers, fragmentedMin, compactedMin);
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printTableTitle("DLL Traversal Time (s)");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Operation", "Fragmented", "Compacted", "Compacted (THP)");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int operation = 0; operation < 3; operation++)
+    {
+        printf("| %-24s | %-20.6f | %-20.6f | %-20.6f |\n", operations[operation], times[0][operation],
+               times[1][operation], times[2][operation]);
+    }
+    printf("| %-24s | %-20s | %-20.6f | %-20.6f |\n", "Compaction", "-", compactionTimes[0], compactionTimes[1]);
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    destroyDoublyLinkedList(list);
+    for (size_t i = 0; i < (size_t)dataSize * fillers; i++)
+    {
+        free(live[i]);
+    }
+    free(live);
+}
+
+// Rows of the key type benchmark
+enum
+{
+    KEY_AVL_NODE_SIZE,
+    KEY_DLL_NODE_SIZE,
+    KEY_AVL_INSERT,
+    KEY_AVL_LOOKUP,
+    KEY_AVL_MIN_MAX,
+    KEY_AVL_FREQUENT,
+    KEY_DLL_INSERT,
+    KEY_DLL_MIN_MAX,
+    KEY_DLL_FREQUENT,
+    KEY_ROWS
+};
+
+// Runs the key type benchmark for the instantiation with name suffix `Suffix` (see keys.inc), filling column `column`
+#define BENCHMARK_KEY_TYPE(Suffix, keys, column)                                                              \
+    {                                                                                                         \
+        AVLTree##Suffix *avlTree = createAVLTree##Suffix();                                                   \
+        DoublyLinkedList##Suffix *doublyLinkedList = createDoublyLinkedList##Suffix();                        \
+        results[KEY_AVL_NODE_SIZE][column] = sizeof(AVLNode##Suffix);                                         \
+        results[KEY_DLL_NODE_SIZE][column] = sizeof(DLLNode##Suffix);                                         \
+                                                                                                              \
+        double start = wallTime();                                                                            \
+        insertDataAVL##Suffix(avlTree, keys, dataSize);                                                       \
+        results[KEY_AVL_INSERT][column] = wallTime() - start;                                                 \
+        start = wallTime();                                                                                   \
+        for (int i = 0; i < lookups; i++)                                                                     \
+        {                                                                                                     \
+            searchAVL##Suffix(avlTree, keys[lookupIndexes[i]]);                                               \
+        }                                                                                                     \
+        results[KEY_AVL_LOOKUP][column] = wallTime() - start;                                                 \
+        start = wallTime();                                                                                   \
+        findMinAVL##Suffix(avlTree);                                                                          \
+        findMaxAVL##Suffix(avlTree);                                                                          \
+        results[KEY_AVL_MIN_MAX][column] = wallTime() - start;                                                \
+        start = wallTime();                                                                                   \
+        free(findXMostFrequentAVL##Suffix(avlTree, 10, dataSize));                                            \
+        results[KEY_AVL_FREQUENT][column] = wallTime() - start;                                               \
+                                                                                                              \
+        start = wallTime();                                                                                   \
+        insertDataDLL##Suffix(doublyLinkedList, keys, dataSize);                                              \
+        results[KEY_DLL_INSERT][column] = wallTime() - start;                                                 \
+        start = wallTime();                                                                                   \
+        findMinDLL##Suffix(doublyLinkedList);                                                                 \
+        findMaxDLL##Suffix(doublyLinkedList);                                                                 \
+        results[KEY_DLL_MIN_MAX][column] = wallTime() - start;                                                \
+        start = wallTime();                                                                                   \
+        free(findXMostFrequentDLL##Suffix(doublyLinkedList, 10, dataSize));                                   \
+        results[KEY_DLL_FREQUENT][column] = wallTime() - start;                                               \
+                                                                                                              \
+        destroyAVLTree##Suffix(avlTree);                                                                      \
+        destroyDoublyLinkedList##Suffix(doublyLinkedList);                                                    \
+    }
+
+// Function to benchmark the AVL Tree and the Doubly-Linked List with each supported key type
+void benchmarkKeyTypes(int *dataset, int dataSize, int lookups)
+{
+    const char *rows[] = {"AVL node (bytes)", "DLL node (bytes)", "AVL insert (s)", "AVL lookups (s)",
+                          "AVL min + max (s)", "AVL 10 most freq. (s)", "DLL insert (s)", "DLL min + max (s)",
+                          "DLL 10 most freq. (s)"};
+    double results[KEY_ROWS][4];
+    int *keys32 = malloc(dataSize * sizeof(int));
+    int64_t *keys64 = malloc(dataSize * sizeof(int64_t));
+    double *keysDouble = malloc(dataSize * sizeof(double));
+    Key16 *keysString = malloc(dataSize * sizeof(Key16));
+    int *lookupIndexes = malloc(lookups * sizeof(int));
+
+    // Derive order-preserving keys of each type from the dataset
+    for (int i = 0; i < dataSize; i++)
+    {
+        keys32[i] = dataset[i];
+        keys64[i] = (int64_t)dataset[i] * 2654435761LL;
+        keysDouble[i] = dataset[i] + 0.5;
+        snprintf(keysString[i].bytes, sizeof(keysString[i].bytes), "%015d", dataset[i]);
+    }
+    for (int i = 0; i < lookups; i++)
+    {
+        lookupIndexes[i] = rand() % dataSize;
+    }
+
+    BENCHMARK_KEY_TYPE(, keys32, 0)
+    BENCHMARK_KEY_TYPE(Int64, keys64, 1)
+    BENCHMARK_KEY_TYPE(Double, keysDouble, 2)
+    BENCHMARK_KEY_TYPE(String16, keysString, 3)
+    comparisonCount = 0;
+    rotationCount = 0;
+
+    // Print the benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printTableTitle("Key Types");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-25s | %-14s | %-14s | %-14s | %-14s |\n", "Operation", "int32", "int64", "double", "string16");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int row = 0; row < KEY_ROWS; row++)
+    {
+        printf("| %-25s |", rows[row]);
+        for (int column = 0; column < 4; column++)
+        {
+            if (row <= KEY_DLL_NODE_SIZE)
+                printf(" %-14.0f |", results[row][column]);
+            else
+                printf(" %-14.6f |", results[row][column]);
+        }
+        printf("\n");
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    free(keys32);
+    free(keys64);
+    free(keysDouble);
+    free(keysString);
+    free(lookupIndexes);
+}
+
+// Helper function to read a cache size in bytes from sysconf, 0 when unknown
+long readCacheSize(int level)
+{
+    long size = 0;
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+    size = sysconf(level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+#endif
+    return size > 0 ? size : 0;
+}
+
+// Helper function to read the memory of the first NUMA node in bytes, or of the whole machine without NUMA info
+long long readNodeMemory(long long memory)
+{
+    FILE *file = fopen("/sys/devices/system/node/node0/meminfo", "r");
+    if (file == NULL)
+        return memory;
+
+    char line[256];
+    long long kilobytes;
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (sscanf(line, "Node %*d MemTotal: %lld kB", &kilobytes) == 1)
+        {
+            memory = kilobytes * 1024;
+            break;
+        }
+    }
+    fclose(file);
+    return memory;
+}
+
+// Function to benchmark lookups in the frozen Eytzinger snapshot against the pointer tree, for growing sizes
+void benchmarkFrozen(int maxSize, int lookups)
+{
+    long l2 = readCacheSize(2);
+    long l3 = readCacheSize(3);
+    long long memory = (long long)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+    long long nodeMemory = readNodeMemory(memory);
+    int *queries = malloc(lookups * sizeof(int));
+
+    printf("\nL2: %ld KB, L3: %ld KB, RAM per NUMA node: %lld MB of %lld MB (AVL node: %zu bytes)\n", l2 / 1024,
+           l3 / 1024, nodeMemory / (1024 * 1024), memory / (1024 * 1024), sizeof(AVLNode));
+
+    // Each key costs a malloc'ed node plus its frozen key, its rank and a sorted copy while freezing
+    long long bytesPerKey = sizeof(AVLNode) + 16 + 3 * sizeof(int);
+    if ((long long)maxSize * bytesPerKey > memory)
+    {
+        maxSize = (int)(memory / bytesPerKey);
+        printf("Sizes capped at %d keys to fit in RAM\n", maxSize);
+    }
+    printf("\n");
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printTableTitle("Lookup Throughput (million lookups/s)");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Keys (pointer tree size)", "Pointer tree", "Frozen", "Speedup");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+
+    // Quadruple the size each round, always finishing with maxSize itself
+    for (long long size = maxSize < 4096 ? maxSize : 4096; size <= maxSize;
+         size = size < maxSize && size * 4 > maxSize ? maxSize : size * 4)
+    {
+        // Even keys in random order, so that half of the uniform queries hit
+        int dataSize = (int)size;
+        int *keys = malloc(dataSize * sizeof(int));
+        for (int i = 0; i < dataSize; i++)
+        {
+            keys[i] = 2 * i;
+        }
+        for (int i = dataSize - 1; i > 0; i--)
+        {
+            int j = rand() % (i + 1);
+            int temp = keys[i];
+            keys[i] = keys[j];
+            keys[j] = temp;
+        }
+        for (int i = 0; i < lookups; i++)
+        {
+            queries[i] = rand() % (2 * dataSize);
+        }
+
+        AVLTree *tree = createAVLTree();
+        insertDataAVL(tree, keys, dataSize);
+        free(keys);
+        FrozenAVL *frozen = freezeAVL(tree);
+
+        int pointerHits = 0, frozenHits = 0;
+        double start = wallTime();
+        for (int i = 0; i < lookups; i++)
+        {
+            pointerHits += searchAVL(tree, queries[i]);
+        }
+        double pointerTime = wallTime() - start;
+        start = wallTime();
+        for (int i = 0; i < lookups; i++)
+        {
+            frozenHits += searchFrozenAVL(frozen, queries[i]);
+        }
+        double frozenTime = wallTime() - start;
+        comparisonCount = 0;
+        rotationCount = 0;
+
+        // Label each size with the first memory level its pointer tree no longer fits in
+        long long footprint = size * (long long)sizeof(AVLNode);
+        const char *level = footprint > nodeMemory ? ">node RAM"
+                            : footprint > l3     ? ">L3"
+                            : footprint > l2     ? ">L2"
+                                                 : "<=L2";
+        char label[32];
+        snprintf(label, sizeof(label), "%d (%s)", dataSize, l2 > 0 ? level : "?");
+        printf("| %-24s | %-20.2f | %-20.2f | %-20.2f |%s\n", label, lookups / pointerTime / 1e6,
+               lookups / frozenTime / 1e6, pointerTime / frozenTime, pointerHits == frozenHits ? "" : " hit mismatch");
+
+        destroyFrozenAVL(frozen);
+        destroyAVLTree(tree);
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    free(queries);
+}
+
+// Measurement sent back by an isolated child
+typedef struct IsolatedResult
+{
+    double time;
+    unsigned long long comparisons;
+    bool pinned;
+} IsolatedResult;
+
+// Helper function to evict the caches by writing a buffer larger than the last-level cache
+void flushCaches()
+{
+    long l3 = readCacheSize(3);
+    size_t bytes = l3 > 0 ? 2 * (size_t)l3 : 64 * 1024 * 1024;
+    volatile char *buffer = malloc(bytes);
+    for (size_t i = 0; i < bytes; i += 64)
+    {
+        buffer[i] = (char)i;
+    }
+    free((void *)buffer);
+}
+
+// Helper function to build one structure and measure one operation on it, run inside the child
+IsolatedResult measureIsolated(bool avl, int operation, int *dataset, int dataSize, bool flush)
+{
+    IsolatedResult result = {0, 0, false};
+    AVLTree *avlTree = createAVLTree();
+    DoublyLinkedList *doublyLinkedList = createDoublyLinkedList();
+    KeyFrequency *mostFrequent = NULL;
+
+    if (operation != 0)
+    {
+        if (avl)
+            insertDataAVL(avlTree, dataset, dataSize);
+        else
+            insertDataDLL(doublyLinkedList, dataset, dataSize);
+    }
+    if (flush)
+        flushCaches();
+
+    comparisonCount = 0;
+    double start = wallTime();
+    switch (operation)
+    {
+    case 0:
+        if (avl)
+            insertDataAVL(avlTree, dataset, dataSize);
+        else
+            insertDataDLL(doublyLinkedList, dataset, dataSize);
+        break;
+    case 1:
+        avl ? findMinAVL(avlTree) : findMinDLL(doublyLinkedList);
+        break;
+    case 2:
+        avl ? findMaxAVL(avlTree) : findMaxDLL(doublyLinkedList);
+        break;
+    case 3:
+        avl ? calculateAverageAVL(avlTree) : calculateAverageDLL(doublyLinkedList);
+        break;
+    default:
+    {
+        int X = operation == 4 ? 10 : 50;
+        mostFrequent =
+            avl ? findXMostFrequentAVL(avlTree, X, dataSize) : findXMostFrequentDLL(doublyLinkedList, X, dataSize);
+        break;
+    }
+    }
+    result.time = wallTime() - start;
+    result.comparisons = comparisonCount;
+
+    free(mostFrequent);
+    destroyAVLTree(avlTree);
+    destroyDoublyLinkedList(doublyLinkedList);
+    return result;
+}
+
+// Helper function to run one measurement in a forked child pinned to `cpu`, returning false on failure
+bool runIsolated(bool avl, int operation, int *dataset, int dataSize, int cpu, bool flush, IsolatedResult *result)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        // The child starts from the parent's heap, which holds nothing but the dataset
+        close(fds[0]);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        bool pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+
+        IsolatedResult measured = measureIsolated(avl, operation, dataset, dataSize, flush);
+        measured.pinned = pinned;
+        ssize_t written = write(fds[1], &measured, sizeof(measured));
+        close(fds[1]);
+        _exit(written == sizeof(measured) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t received = read(fds[0], result, sizeof(*result));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+
+    return received == sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Helper function to compare two times for qsort
+int compareTimes(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Function to benchmark every structure/operation pair in its own pinned child process
+void benchmarkIsolated(int *dataset, int dataSize, int cpu, bool flush)
+{
+    const char *operations[] = {"Insert data", "Find min", "Find max", "Calculate average", "Find 10 most frequent",
+                                "Find 50 most frequent"};
+    double medians[ISOLATION_OPERATIONS][2];
+    unsigned long long comparisons[ISOLATION_OPERATIONS][2];
+    bool pinned = true;
+
+    if (cpu >= CPU_SETSIZE)
+    {
+        printf("Invalid CPU. Please provide a value below %d.\n", CPU_SETSIZE);
+        return;
+    }
+
+    for (int operation = 0; operation < ISOLATION_OPERATIONS; operation++)
+    {
+        double times[2][ISOLATION_RUNS];
+        for (int run = 0; run < ISOLATION_RUNS; run++)
+        {
+            // Alternate which structure goes first, so any leftover order effect shows up as spread
+            for (int turn = 0; turn < 2; turn++)
+            {
+                int structure = (run + turn) % 2;
+                IsolatedResult result;
+                if (!runIsolated(structure == 0, operation, dataset, dataSize, cpu, flush, &result))
+                {
+                    printf("Isolated run failed (%s).\n", operations[operation]);
+                    return;
+                }
+                times[structure][run] = result.time;
+                comparisons[operation][structure] = result.comparisons;
+                pinned = pinned && result.pinned;
+            }
+        }
+
+        for (int structure = 0; structure < 2; structure++)
+        {
+            qsort(times[structure], ISOLATION_RUNS, sizeof(double), compareTimes);
+            medians[operation][structure] = times[structure][ISOLATION_RUNS / 2];
+        }
+    }
+
+    printf("Isolation: %d runs per structure/operation, CPU %d%s, caches %s\n\n", ISOLATION_RUNS, cpu,
+           pinned ? "" : " (pinning failed)", flush ? "flushed" : "not flushed");
+
+    // Print the time benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printTableTitle("Median Execution Time (s)");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Operation", "AVL Tree", "Doubly-Linked List", "AVL/DLL Ratio");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int operation = 0; operation < ISOLATION_OPERATIONS; operation++)
+    {
+        printf("| %-24s | %-20.6f | %-20.6f | %-20.2f |\n", operations[operation], medians[operation][0],
+               medians[operation][1], medians[operation][0] / medians[operation][1]);
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
+
+    // Print the comparison benchmarks in table format
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printTableTitle("Number of Comparisons");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    printf("| %-24s | %-20s | %-20s | %-20s |\n", "Operation", "AVL Tree", "Doubly-Linked List", "AVL/DLL Ratio");
+    printf("|-----------------------------------------------------------------------------------------------|\n");
+    for (int operation = 0; operation < ISOLATION_OPERATIONS; operation++)
+    {
+        printf("| %-24s | %-20lli | %-20lli | %-20.2Lf |\n", operations[operation], comparisons[operation][0],
+               comparisons[operation][1], comparisons[operation][0] / (long double)comparisons[operation][1]);
+    }
+    printf("+-----------------------------------------------------------------------------------------------+\n");
+    printf("\n");
 }
 
 int main(int argc, char *argv[])
 {
-    if (argc != 3)
+    if (argc != 3 && argc != 5)
     {
-        printf("Usage: %s <ordered/unordered> <dataSize>\n", argv[0]);
+        printf("Usage: %s <ordered/unordered> <dataSize> [<mode> <modeArg>]\n", argv[0]);
+        printf("Modes:\n");
+        printf("  window <W>               statistics over the last W insertions\n");
+        printf("  parallel <threads>       parallel AVL build with up to <threads> threads (at most %d)\n",
+               MAX_BUILD_THREADS);
+        printf("  setops <maxRatio>        join-based set operations for size ratios up to <maxRatio>\n");
+        printf("  batch <maxBatch>         sorted batched AVL insertion for batch sizes up to <maxBatch>\n");
+        printf("  sweep <minSize>          every operation from <minSize> to <dataSize>, both order types\n");
+        printf("  latency <lookups>        per-operation latency percentiles, inserts split by rotations\n");
+        printf("  topk <refreshes>         top-10/50/100/1000 per refresh, separate calls vs. one cached query\n");
+        printf("  compact <fillers>        DLL traversal on a fragmented heap, before and after compaction\n");
+        printf("  keys <lookups>           int32, int64, double and 16-byte string keys side by side\n");
+        printf("  freeze <lookups>         frozen Eytzinger lookups vs. the pointer tree, sizes up to <dataSize>\n");
+        printf("  isolate <cpu>            every structure/operation in its own child pinned to <cpu>\n");
+        printf("  isolate-flush <cpu>      same, flushing the caches before each measured operation\n");
         return 1;
     }
 
     // Parse command-line arguments
     char *orderType = argv[1];
     int dataSize = atoi(argv[2]);
+    char *mode = argc == 5 ? argv[3] : NULL;
+    int modeArg = argc == 5 ? atoi(argv[4]) : 0;
 
-    if (dataSize <= 0 || dataSize > MAX_DATASIZE)
+    bool sizeLadder = mode != NULL && (strcmp(mode, "sweep") == 0 || strcmp(mode, "freeze") == 0);
+    int maxDataSize = !sizeLadder                   ? MAX_DATASIZE
+                      : strcmp(mode, "freeze") == 0 ? MAX_FREEZE_DATASIZE
+                                                    : MAX_SWEEP_DATASIZE;
+    if (dataSize <= 0 || dataSize > maxDataSize)
     {
-        printf("Invalid data size. Please provide a value between 1 and %d.\n", MAX_DATASIZE);
+        printf("Invalid data size. Please provide a value between 1 and %d.\n", maxDataSize);
         return 1;
     }
     if (!(strcmp(orderType, "ordered") == 0 || strcmp(orderType, "unordered") == 0))
@@ -95,9 +1452,64 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    bool validMode = mode == NULL;
+    for (int i = 0; i < (int)(sizeof(modes) / sizeof(modes[0])) && !validMode; i++)
+    {
+        validMode = strcmp(mode, modes[i]) == 0;
+    }
+    if (!validMode)
+    {
+        printf("Invalid mode '%s'.\n", mode);
+        return 1;
+    }
+    bool isolation = mode != NULL && strncmp(mode, "isolate", 7) == 0;
+    if (mode != NULL && (modeArg < 0 || (modeArg == 0 && !isolation)))
+    {
+        printf("Invalid mode argument. Please provide a positive value.\n");
+        return 1;
+    }
+
+    // The sweep and the freeze modes generate their own datasets for every size
+    if (mode != NULL && strcmp(mode, "sweep") == 0)
+    {
+        benchmarkSweep(modeArg < dataSize ? modeArg : dataSize, dataSize);
+        return 0;
+    }
+    if (mode != NULL && strcmp(mode, "freeze") == 0)
+    {
+        benchmarkFrozen(dataSize, modeArg);
+        return 0;
+    }
+
     // Generate the dataset
     int *dataset = generateData(orderType, dataSize);
 
+    // Run the requested benchmark mode instead of the full comparison
+    if (mode != NULL)
+    {
+        printf("\nDataset: %d %s elements\n", dataSize, orderType);
+        if (strcmp(mode, "window") == 0)
+            benchmarkWindow(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "parallel") == 0)
+            benchmarkParallelBuild(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "setops") == 0)
+            benchmarkSetOperations(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "batch") == 0)
+            benchmarkBatchInsertion(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "latency") == 0)
+            benchmarkLatency(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "topk") == 0)
+            benchmarkTopFrequencies(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "compact") == 0)
+            benchmarkCompaction(dataset, dataSize, modeArg);
+        else if (strcmp(mode, "keys") == 0)
+            benchmarkKeyTypes(dataset, dataSize, modeArg);
+        else if (isolation)
+            benchmarkIsolated(dataset, dataSize, modeArg, strcmp(mode, "isolate-flush") == 0);
+        free(dataset);
+        return 0;
+    }
+
     // Create the data structures
     AVLTree *avlTree = createAVLTree();
     DoublyLinkedList *doublyLinkedList = createDoublyLinkedList();
@@ -270,6 +1682,11 @@ int main(int argc, char *argv[])
     printf("\n");
 
     // Destroy the data structures to free memory
+    free(avlMostFrequent10);
+    free(dllMostFrequent10);
+    free(avlMostFrequent50);
+    free(dllMostFrequent50);
+    free(dataset);
     destroyAVLTree(avlTree);
     destroyDoublyLinkedList(doublyLinkedList);
 
@@ -1,14 +1,10 @@
 #ifndef MAIN_H
 #define MAIN_H
 
-// Structure to store key-frequency pairs
-typedef struct
-{
-    int key;
-    int frequency;
-} KeyFrequency;
+#include "freq.h"
 
 void compare();
+void rotate();
 void printMostFrequent(KeyFrequency *result, int X);
 
 #endif /* MAIN_H */